@@ -0,0 +1,53 @@
+#!/bin/sh
+# Compares a benchmark result with a stored baseline (both written by
+# run_bench.sh) and flags regressions larger than the tolerance:
+# lower events/s, higher startup time, peak memory or bytes per event.
+# Exits with status 1 if a workload regressed.
+#
+# usage: compare_bench.sh <baseline.json> <result.json> [tolerance %]
+
+BASELINE=$1
+RESULT=$2
+TOLERANCE=${3:-5}
+if [ ! -f "$BASELINE" ] || [ ! -f "$RESULT" ]; then
+  echo "usage: $0 <baseline.json> <result.json> [tolerance %]"
+  exit 1
+fi
+
+awk -v tolerance="$TOLERANCE" '
+  function value(line, key,    pattern) {
+    pattern = "\"" key "\": \"?[^,}\"]*"
+    if (!match(line, pattern)) return ""
+    line = substr(line, RSTART + length(key) + 4, RLENGTH - length(key) - 4)
+    gsub(/"/, "", line)
+    return line
+  }
+  # higher_is_better : 1 for events/s, 0 for the costs
+  function check(name, key, base, current, higher_is_better,    change, flag) {
+    if (base == "" || current == "" || base == 0) return
+    change = 100.*(current - base)/base
+    flag = ""
+    if ((higher_is_better && change < -tolerance) || 
+        (!higher_is_better && change > tolerance)) {
+      flag = "  REGRESSION"
+      regressions++
+    }
+    printf "%-18s %-16s %12.3f %12.3f %+8.1f%%%s\n", 
+           name, key, base, current, change, flag
+  }
+  /"name":/ {
+    name = value($0, "name")
+    if (FILENAME == ARGV[1]) { baseline[name] = $0; next }
+    if (!(name in baseline)) { printf "%-18s not in the baseline\n", name; next }
+    check(name, "events_per_s", value(baseline[name], "events_per_s"), value($0, "events_per_s"), 1)
+    check(name, "startup_s", value(baseline[name], "startup_s"), value($0, "startup_s"), 0)
+    check(name, "peak_rss_mb", value(baseline[name], "peak_rss_mb"), value($0, "peak_rss_mb"), 0)
+    check(name, "bytes_per_event", value(baseline[name], "bytes_per_event"), value($0, "bytes_per_event"), 0)
+  }
+  BEGIN {
+    printf "%-18s %-16s %12s %12s %9s\n", "workload", "metric", "baseline", "current", "change"
+  }
+  END {
+    if (regressions) { printf "%d regression(s) above %s %%\n", regressions, tolerance; exit 1 }
+    print "no regression"
+  }' "$BASELINE" "$RESULT"
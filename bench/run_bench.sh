@@ -0,0 +1,103 @@
+#!/bin/sh
+# End-to-end benchmark suite of proton_pol (make bench)
+#
+# Runs a fixed set of workloads with a fixed seed and event seeding and
+# writes, per workload, events/s, startup time (the master phases of the
+# StartupTimer report, --startup-report), peak resident memory and output
+# bytes per event to a JSON file, one workload per line.
+#
+# usage: run_bench.sh <execute-proton_pol_batch> <result.json> [events] [threads]
+
+PROGRAM=$1
+RESULT=$2
+EVENTS=${3:-2000}
+THREADS=${4:-4}
+if [ -z "$PROGRAM" ] || [ -z "$RESULT" ]; then
+  echo "usage: $0 <execute-proton_pol_batch> <result.json> [events] [threads]"
+  exit 1
+fi
+
+BENCH_DIR=$(cd "$(dirname "$0")" && pwd)
+WORK_DIR=$(cd "$(dirname "$RESULT")" && pwd)/bench_work
+mkdir -p "$WORK_DIR"
+
+# name threads physics macro
+WORKLOADS="
+default_1t        1          QGSP_BERT_HP    -
+default_${THREADS}t $THREADS QGSP_BERT_HP    -
+minimal_1t        1          emstandard_opt0 -
+biasing_1t        1          QGSP_BERT_HP    biasing.mac
+no_ntuple_1t      1          QGSP_BERT_HP    no_ntuple.mac
+"
+
+{
+  echo "{"
+  echo "  \"events\": $EVENTS,"
+  echo "  \"workloads\": ["
+} > "$RESULT"
+
+SEPARATOR=" "
+STATUS=0
+while read -r NAME NTHREADS PHYSICS MACRO; do
+  [ -z "$NAME" ] && continue
+  OUTPUT=$WORK_DIR/$NAME
+  rm -f "$OUTPUT".* "$OUTPUT"_*
+
+  set -- --threads "$NTHREADS" --events "$EVENTS" --seed 12345 --event-seeding \
+         --physics "$PHYSICS" --output "$OUTPUT" --timing-report "$OUTPUT.timing" \
+         --startup-report "$OUTPUT.startup"
+  [ "$MACRO" != "-" ] && set -- "$@" --macro "$BENCH_DIR/$MACRO"
+
+  echo "bench: $NAME ($NTHREADS thread(s), $PHYSICS, $MACRO)"
+  if ! (cd "$WORK_DIR" && "$PROGRAM" "$@" > "$OUTPUT.log" 2>&1); then
+    echo "bench: $NAME failed, see $OUTPUT.log"
+    STATUS=1
+    continue
+  fi
+
+  BYTES=$(cat "$OUTPUT".root "$OUTPUT"_*.ppcol 2>/dev/null | wc -c)
+  # startup : the master phases of the startup report, nested phases
+  # (Construct in Initialize, ...) counted once, and the total per phase
+  awk -v name="$NAME" -v threads="$NTHREADS" \
+      -v bytes="$BYTES" -v separator="$SEPARATOR" '
+    FILENAME ~ /timing$/ && /^events/      { events = $2 }
+    FILENAME ~ /timing$/ && /^wall/        { wall = $2 }
+    FILENAME ~ /timing$/ && /^peak_rss_mb/ { rss = $2 }
+    FILENAME ~ /startup$/ && /"thread"/ { master = ($0 ~ /"master"/) }
+    FILENAME ~ /startup$/ && master && /"name"/ {
+      split($0, field, "\"")
+      phase = field[4]
+      line = $0
+      sub(/.*"start": /, "", line); phase_start = line + 0
+      sub(/.*"seconds": /, "", line); seconds = line + 0
+      if (!(phase in phase_seconds)) order[++nphases] = phase
+      phase_seconds[phase] += seconds
+      # phases are in start order: only the time outside the previous ones
+      phase_end = phase_start + seconds
+      if (phase_end > covered) {
+        startup += phase_end - (phase_start > covered ? phase_start : covered)
+        covered = phase_end
+      }
+    }
+    END {
+      printf "   %s{\"name\": \"%s\", \"threads\": %d, \"events_per_s\": %.3f, ",
+             separator, name, threads, (wall > 0 ? events/wall : 0)
+      printf "\"startup_s\": %.3f, \"startup_phases_s\": {", startup
+      for (i = 1; i <= nphases; ++i) {
+        printf "%s\"%s\": %.3f", (i > 1 ? ", " : ""), order[i], phase_seconds[order[i]]
+      }
+      printf "}, \"peak_rss_mb\": %.1f, \"bytes_per_event\": %.1f}\n",
+             rss, (events > 0 ? bytes/events : 0)
+    }' "$OUTPUT.timing" "$OUTPUT.startup" >> "$RESULT"
+  SEPARATOR=","
+done <<EOF
+$WORKLOADS
+EOF
+
+{
+  echo "  ]"
+  echo "}"
+} >> "$RESULT"
+
+echo "bench: results in $RESULT"
+exit $STATUS
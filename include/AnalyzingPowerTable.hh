@@ -0,0 +1,69 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file AnalyzingPowerTable.hh
+/// \brief Definition of the AnalyzingPowerTable class
+
+#ifndef AnalyzingPowerTable_h
+#define AnalyzingPowerTable_h 1
+
+#include <string>
+#include <vector>
+
+/// Tabulated analyzing power A_y(theta, T) of the polarimeter
+///
+/// Read from
+/// - the asymmetry CSV file of AsymmetryAccumulator::Write() (calibration
+///   run with a known polarization) : A_y at the centre of every theta bin
+/// - a text file with one "theta A_y" pair per line (# : comment)
+/// - a text file with one "theta T A_y" triplet per line, on a full grid
+///   of theta and kinetic energy T (MeV) values, in any order
+/// and interpolated linearly in theta (deg) and T, constant outside the
+/// table. Tables without T do not depend on the energy.
+///
+/// The class does not depend on Geant4.
+
+class AnalyzingPowerTable
+{
+  public:
+    AnalyzingPowerTable();
+    ~AnalyzingPowerTable();
+
+    bool Read(const std::string& path);
+    bool IsEmpty() const { return theta_.empty(); }
+
+    bool HasEnergy() const { return energy_.size() > 1; }
+    double GetValue(double theta, double energy = 0.) const;
+
+  private:
+    std::vector<double> theta_;
+    std::vector<double> energy_;
+    std::vector<double> values_;     // theta-major
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
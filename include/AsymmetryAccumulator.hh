@@ -0,0 +1,122 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file AsymmetryAccumulator.hh
+/// \brief Definition of the AsymmetryAccumulator class
+
+#ifndef AsymmetryAccumulator_h
+#define AsymmetryAccumulator_h 1
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// Streaming azimuthal asymmetry accumulator
+///
+/// Weighted sums per theta bin of the scattered proton, for
+/// - four phi sectors of 90 deg centred on +x, +y, -x and -y
+/// - the cos(phi) and sin(phi) moments
+/// plus the weighted number of incident events, so that
+///   eps_LR = (N(+x) - N(-x)) / (N(+x) + N(-x))
+///   eps_UD = (N(+y) - N(-y)) / (N(+y) + N(-y))
+///   A_y    = 2 <cos(phi)> / P       (beam polarization P along +y)
+///   FOM    = efficiency x A_y^2    (efficiency = N(theta bin) / N(incident))
+/// and their statistical errors (including the spread of the weights)
+/// can be computed at any time. Accumulators of different threads are
+/// combined with Merge(); Save() and Load() keep the raw sums in a text
+/// file, so accumulators of different processes can be merged too.
+///
+/// The class does not depend on Geant4; angles are given in degrees
+/// (theta) and radians (phi).
+
+class AsymmetryAccumulator
+{
+  public:
+    /// Quantities of one theta bin (or of a theta window)
+    struct Result {
+      double theta_low;
+      double theta_high;
+      double counts;       // sum of weights
+      double efficiency;
+      double eps_lr, eps_lr_error;
+      double eps_ud, eps_ud_error;
+      double analyzing_power, analyzing_power_error;  // from <cos(phi)>
+      double sin_asymmetry, sin_asymmetry_error;      // 2 <sin(phi)> / P
+      double fom;
+    };
+
+    AsymmetryAccumulator(int nbins = 20, double theta_min = 5., double theta_max = 25.);
+    ~AsymmetryAccumulator();
+
+    void SetBinning(int nbins, double theta_min, double theta_max);
+    void Reset();
+
+    inline void AddEvent(double weight) { events_ += weight; }
+    void Fill(double theta, double phi, double weight);
+    // same with the direction of phi (no trigonometric function)
+    void FillDirection(double theta, double cos_phi, double sin_phi, double weight);
+    void Merge(const AsymmetryAccumulator& other);
+
+    int GetNbins() const { return nbins_; }
+    double GetThetaMin() const { return theta_min_; }
+    double GetThetaMax() const { return theta_max_; }
+    double GetEvents() const { return events_; }
+
+    Result GetResult(int bin, double polarization) const;
+    // sum of the bins fully inside [theta_low, theta_high]
+    Result GetWindowResult(double theta_low, double theta_high, double polarization) const;
+
+    void Print(std::ostream& output, double polarization,
+               double window_low, double window_high) const;
+    bool Write(const std::string& path, double polarization) const;
+
+    // raw sums (state of the accumulator), exact in a round trip
+    bool Save(const std::string& path) const;
+    bool Load(const std::string& path);
+
+  private:
+    enum { kPlusX, kPlusY, kMinusX, kMinusY, kSectors };
+
+    struct Bin {
+      double sum_w, sum_w2;
+      double sector_w[kSectors], sector_w2[kSectors];
+      // moments of x = cos(phi), sin(phi) : sum w x, sum w^2 x, sum w^2 x^2
+      double cos_w, cos_w2, cos2_w2;
+      double sin_w, sin_w2, sin2_w2;
+    };
+
+    void Add(Bin& sum, const Bin& bin) const;
+    Result Evaluate(const Bin& bin, double polarization) const;
+
+    int nbins_;
+    double theta_min_, theta_max_;
+    double events_;
+    std::vector<Bin> bins_;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
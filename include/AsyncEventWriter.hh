@@ -0,0 +1,140 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file AsyncEventWriter.hh
+/// \brief Definition of the AsyncEventWriter class
+
+#ifndef AsyncEventWriter_h
+#define AsyncEventWriter_h 1
+
+#include "globals.hh"
+#include "EventRecord.hh"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ColumnarWriter;
+
+/// Single-producer single-consumer ring buffer of event records
+///
+/// The capacity is rounded up to a power of two. Push() is called by the
+/// thread which processes the events only, Pop() by the writer thread
+/// only; neither takes a lock.
+
+class EventRing
+{
+  public:
+    explicit EventRing(std::size_t capacity);
+
+    G4bool Push(const EventRecord& record);   // false when full
+    G4bool Pop(EventRecord& record);          // false when empty
+
+    inline std::size_t GetDepth() const
+    { return head_.load(std::memory_order_acquire) 
+           - tail_.load(std::memory_order_acquire); }
+    inline std::size_t GetCapacity() const { return records_.size(); }
+
+  private:
+    std::vector<EventRecord> records_;
+    std::size_t mask_;
+    alignas(64) std::atomic<std::size_t> head_;  // next record to write
+    alignas(64) std::atomic<std::size_t> tail_;  // next record to read
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Asynchronous columnar event output, one instance per process
+///
+/// Each thread which processes events registers a Channel: its ring
+/// buffer and its ColumnarWriter. A dedicated writer thread drains the
+/// rings in batches into the writers, so the block compression and the
+/// file writes leave the event loop. When a ring is full the producer
+/// either waits for the writer (back pressure "block", no event lost) or
+/// drops the record (back pressure "drop"); both are counted, with the
+/// queue depth, in the channel statistics.
+///
+/// The instance is created by the master RunAction before the workers
+/// start; the writer thread runs while channels are registered.
+
+class AsyncEventWriter
+{
+  public:
+    enum BackPressure { kBlock, kDrop };
+
+    struct Channel 
+    {
+      Channel(std::size_t capacity, ColumnarWriter* writer, BackPressure policy);
+      
+      // producer side
+      void Push(const EventRecord& record);
+
+      EventRing ring;
+      ColumnarWriter* writer;
+      BackPressure back_pressure;
+
+      // statistics of the producer
+      G4long records;
+      G4long stalls;      // full ring, waited for the writer thread
+      G4long dropped;     // full ring, record not written
+      std::size_t max_depth;
+      G4double depth_sum;
+
+      // writer thread statistics
+      G4long batches;
+
+      std::atomic<G4bool> closing;
+      G4bool drained;
+    };
+
+    static AsyncEventWriter* Instance();
+    ~AsyncEventWriter();
+
+    void Register(Channel* channel);
+    // waits until the writer thread has written all records of the channel
+    void Unregister(Channel* channel);
+
+  private:
+    AsyncEventWriter();
+
+    void Loop();
+    std::size_t Drain(Channel* channel);
+
+    std::vector<Channel*> channels_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    G4bool stop_;
+
+    static const std::size_t kMaxBatch = 1024;
+    static AsyncEventWriter* fgInstance;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
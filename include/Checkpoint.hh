@@ -0,0 +1,108 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file Checkpoint.hh
+/// \brief Definition of the Checkpoint class
+
+#ifndef Checkpoint_h
+#define Checkpoint_h 1
+
+#include "globals.hh"
+#include "Analysis.hh"
+#include "AsymmetryAccumulator.hh"
+
+#include "tools/histo/h1d"
+#include "tools/histo/h2d"
+
+#include <vector>
+
+class CommandLineOptions;
+class Run;
+
+/// Checkpointed job (--checkpoint dir), one instance per process
+///
+/// The events are processed as a chain of runs (segments) of
+/// --checkpoint-every events, or of the events of about
+/// --checkpoint-minutes, with event seeding from one run seed and
+/// consecutive event IDs (/proton_pol/run/eventOffset). At the end of
+/// every segment the master adds the totals of the previous segments to
+/// the merged histograms and asymmetry of the run before they are written,
+/// so <file>_seg<i>.root and the asymmetry file hold the totals of the job
+/// so far (the ntuple of each file holds the events of its segment). The
+/// columnar files of a segment are <columnar>_seg<i>_run<run>_t<thread>.ppcol,
+/// so the segments of a resumed job do not overwrite the earlier ones.
+/// The checkpoint directory then receives
+/// - asymmetry_seg<i>.state : raw sums of the asymmetry (AsymmetryAccumulator)
+/// - checkpoint.txt         : run seed, events done and to do, segment, the
+///                            files with the histograms and the asymmetry,
+///                            the columnar base name
+/// The files are synced, then checkpoint.txt is written to a temporary file,
+/// synced and renamed: this one rename commits the segment.
+/// --resume continues the job from the last complete segment; as every
+/// event is seeded from (run seed, event ID), the totals are those of an
+/// uninterrupted run.
+
+class Checkpoint
+{
+  public:
+    Checkpoint(const CommandLineOptions& options);
+    ~Checkpoint();
+
+    // null when the job is not checkpointed
+    static Checkpoint* GetInstance() { return fgInstance; }
+
+    G4int Execute();
+
+    // master side, at the end of every segment
+    void Accumulate(Run* run);   // before the histograms are written
+    void Commit();               // after the file is closed
+
+  private:
+    G4bool Load();
+    G4bool WriteAtomically(const G4String& name, const G4String& content) const;
+    G4bool Sync(const G4String& path) const;
+    G4String GetPath(const G4String& name) const;
+    G4String GetSegmentFile(const G4String& file, G4int segment) const;
+
+    const CommandLineOptions& options_;
+    G4String directory_;
+    G4String file_;
+    G4String columnar_file_;
+    G4String asymmetry_file_;    // in the directory, of the last checkpoint
+    G4long seed_;
+    G4long events_;
+    G4long events_done_;
+    G4int segment_;
+    AsymmetryAccumulator asymmetry_;
+    std::vector<tools::histo::h1d> h1_;
+    std::vector<tools::histo::h2d> h2_;
+
+    static Checkpoint* fgInstance;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
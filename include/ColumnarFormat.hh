@@ -0,0 +1,105 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ColumnarFormat.hh
+/// \brief Definition of the proton_pol columnar file format
+///
+/// Native columnar event file (*.ppcol), one file per thread and run.
+/// All values are little endian (the writer and the reader copy them in
+/// host order and refuse to run on a big-endian host); every section
+/// starts 8-byte aligned.
+///
+///   file    := header block* footer trailer
+///   header  := "PPCOL001"            8 bytes magic
+///              uint32 version        (kColumnarVersion)
+///              uint32 ncolumns
+///              ncolumns x column     column := uint8 type, uint8 0,
+///                                              uint16 name length, name
+///              padding to 8 bytes
+///   block   := ncolumns x payload    payload of each column padded to 8 bytes,
+///                                    raw little-endian values or a zlib stream
+///   footer  := uint64 nblocks
+///              nblocks x { uint64 nrows,
+///                          ncolumns x { uint64 offset, uint64 stored size,
+///                                       uint64 raw size, uint32 codec,
+///                                       uint32 0 } }
+///   trailer := uint64 footer offset, "PPCOLEND"
+///
+/// The footer is the index of the file: a reader maps the file, reads the
+/// trailer and can address every column of every block directly.
+/// Uncompressed payloads are aligned and can be used in place.
+///
+/// This header, ColumnarWriter and ColumnarReader do not depend on Geant4
+/// and are built into the proton_pol_columnar library.
+
+#ifndef ColumnarFormat_h
+#define ColumnarFormat_h 1
+
+#include <cstdint>
+#include <cstddef>
+
+constexpr char kColumnarMagic[8] = { 'P','P','C','O','L','0','0','1' };
+constexpr char kColumnarEndMagic[8] = { 'P','P','C','O','L','E','N','D' };
+constexpr std::uint32_t kColumnarVersion = 1;
+
+/// Column value types
+enum ColumnarType : std::uint8_t {
+  kColumnInt32 = 1,
+  kColumnFloat32 = 2,
+  kColumnFloat64 = 3
+};
+
+/// Block compression codecs
+enum ColumnarCodec : std::uint32_t {
+  kCodecNone = 0,
+  kCodecZlib = 1
+};
+
+inline std::size_t ColumnarTypeSize(ColumnarType type)
+{
+  switch (type) {
+    case kColumnInt32: return 4;
+    case kColumnFloat32: return 4;
+    case kColumnFloat64: return 8;
+  }
+  return 0;
+}
+
+// the format is little endian, values are copied in host order
+inline bool ColumnarHostIsLittleEndian()
+{
+  const std::uint16_t one = 1;
+  return *reinterpret_cast<const unsigned char*>(&one) == 1;
+}
+
+inline std::size_t ColumnarPadding(std::size_t size)
+{
+  return (8 - size % 8) % 8;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
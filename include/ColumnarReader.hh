@@ -0,0 +1,109 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ColumnarReader.hh
+/// \brief Definition of the ColumnarReader class
+
+#ifndef ColumnarReader_h
+#define ColumnarReader_h 1
+
+#include "ColumnarFormat.hh"
+
+#include <string>
+#include <vector>
+
+/// Memory-mapped reader of the native columnar event format
+/// (see ColumnarFormat.hh)
+///
+/// The file is mapped read-only. Uncompressed column blocks are returned
+/// in place (zero copy); compressed blocks are inflated into a buffer of
+/// the column which stays valid until the next call for the same column.
+/// A reader is not thread safe: use one reader per thread.
+///
+///   ColumnarReader reader;
+///   reader.Open("proton_pol_run0_t0.ppcol");
+///   auto theta = reader.GetColumnIndex("dcout_momentum_z");
+///   for (std::size_t b = 0; b < reader.GetNumberOfBlocks(); ++b) {
+///     auto pz = reader.GetBlockColumn<float>(b, theta);
+///     for (std::size_t i = 0; i < reader.GetBlockRows(b); ++i) ... pz[i] ...
+///   }
+
+class ColumnarReader
+{
+  public:
+    ColumnarReader();
+    ~ColumnarReader();
+
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return data_ != nullptr; }
+
+    std::size_t GetNumberOfColumns() const { return columns_.size(); }
+    const std::string& GetColumnName(std::size_t column) const { return columns_[column].name; }
+    ColumnarType GetColumnType(std::size_t column) const { return columns_[column].type; }
+    // -1 if there is no column with this name
+    int GetColumnIndex(const std::string& name) const;
+
+    std::size_t GetNumberOfBlocks() const { return blocks_.size(); }
+    std::size_t GetBlockRows(std::size_t block) const { return blocks_[block].rows; }
+    std::size_t GetNumberOfRows() const { return rows_; }
+
+    // nullptr on a corrupted or unsupported block
+    const void* GetBlockData(std::size_t block, std::size_t column);
+    template <class T>
+    const T* GetBlockColumn(std::size_t block, std::size_t column)
+    { return static_cast<const T*>(GetBlockData(block, column)); }
+
+  private:
+    struct Column {
+      std::string name;
+      ColumnarType type;
+      std::vector<unsigned char> inflated;
+    };
+    struct ColumnIndex {
+      std::uint64_t offset;
+      std::uint64_t stored_size;
+      std::uint64_t raw_size;
+      std::uint32_t codec;
+    };
+    struct BlockIndex {
+      std::uint64_t rows;
+      std::vector<ColumnIndex> columns;
+    };
+
+    bool ReadHeader();
+    bool ReadFooter();
+
+    const unsigned char* data_;
+    std::size_t size_;
+    std::size_t rows_;
+    std::vector<Column> columns_;
+    std::vector<BlockIndex> blocks_;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
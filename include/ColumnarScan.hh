@@ -0,0 +1,98 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ColumnarScan.hh
+/// \brief Definition of the ColumnarScan class
+
+#ifndef ColumnarScan_h
+#define ColumnarScan_h 1
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+/// Scattered protons of one column block: the events of the block with a
+/// DCOUT hit, as the analysis of EventAction sees them
+struct ScatteringBatch
+{
+  std::size_t events;      // rows of the block (incident events)
+  std::size_t size;        // rows with a DCOUT hit
+  const double* theta;     // polar angle of the DCOUT momentum (deg)
+  const double* cos_phi;   // azimuth of the DCOUT momentum
+  const double* sin_phi;
+  const double* momentum;  // magnitude of the DCOUT momentum (MeV)
+  const double* energy;    // kinetic energy of a proton of this momentum (MeV)
+  const double* weight;
+};
+
+/// Parallel scan of native columnar event files (see ColumnarFormat.hh)
+///
+/// The blocks of all files are shared out between threads, each with its
+/// own readers. The DCOUT columns of a block are converted into a
+/// ScatteringBatch with branch-free loops over the block (cos and sin of
+/// phi are ratios of the transverse momentum, only theta needs a
+/// function call), then passed to the function of the caller with the
+/// index of the thread, so every thread fills its own accumulators.
+///
+///   ColumnarScan scan(files, 8);
+///   std::vector<AsymmetryAccumulator> sums(scan.GetNumberOfThreads());
+///   scan.Run([&](int thread, const ScatteringBatch& batch) {
+///     sums[thread].FillBatch(batch); });
+///
+/// The class does not depend on Geant4.
+
+class ColumnarScan
+{
+  public:
+    using Function = std::function<void(int thread, const ScatteringBatch& batch)>;
+
+    // threads <= 0 : all hardware threads
+    ColumnarScan(const std::vector<std::string>& files, int threads = 0);
+    ~ColumnarScan();
+
+    // false if a file cannot be read (see GetError())
+    bool Run(const Function& function);
+
+    int GetNumberOfThreads() const { return threads_; }
+    std::size_t GetNumberOfRows() const { return rows_; }
+    const std::string& GetError() const { return error_; }
+
+  private:
+    struct Block {
+      std::size_t file;
+      std::size_t block;
+    };
+
+    std::vector<std::string> files_;
+    int threads_;
+    std::size_t rows_;
+    std::string error_;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,107 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ColumnarWriter.hh
+/// \brief Definition of the ColumnarWriter class
+
+#ifndef ColumnarWriter_h
+#define ColumnarWriter_h 1
+
+#include "ColumnarFormat.hh"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/// Writer of the native columnar event format (see ColumnarFormat.hh)
+///
+/// Columns are declared before Open(); values are filled row by row and
+/// written in blocks of a fixed number of rows. Values not filled in a
+/// row are written as zero. A failed write is remembered: Close() then
+/// returns false and the file must not be used.
+
+class ColumnarWriter
+{
+  public:
+    ColumnarWriter();
+    ~ColumnarWriter();
+
+    int AddColumn(const std::string& name, ColumnarType type);
+
+    bool Open(const std::string& path, ColumnarCodec codec, std::size_t block_rows);
+    bool Close();
+    bool IsOpen() const { return file_ != nullptr; }
+    // kCodecNone when zlib was requested but is not built in
+    ColumnarCodec GetCodec() const { return codec_; }
+
+    // the value is converted to the column type (exact for int32 and float)
+    void Fill(int column, double value);
+    void AddRow();
+
+    // statistics
+    std::size_t GetRawBytes() const { return raw_bytes_; }
+    std::size_t GetStoredBytes() const { return stored_bytes_; }
+
+  private:
+    struct Column {
+      std::string name;
+      ColumnarType type;
+      std::size_t size;
+      std::vector<unsigned char> buffer;
+    };
+    struct ColumnIndex {
+      std::uint64_t offset;
+      std::uint64_t stored_size;
+      std::uint64_t raw_size;
+      std::uint32_t codec;
+    };
+    struct BlockIndex {
+      std::uint64_t rows;
+      std::vector<ColumnIndex> columns;
+    };
+
+    bool WriteHeader();
+    bool FlushBlock();
+    bool WriteFooter();
+    bool WriteBytes(const void* data, std::size_t size);
+    bool WritePadding(std::size_t size);
+
+    std::vector<Column> columns_;
+    std::vector<BlockIndex> blocks_;
+    std::vector<unsigned char> compressed_;
+    std::FILE* file_;
+    ColumnarCodec codec_;
+    std::size_t block_rows_;
+    std::size_t rows_;
+    std::uint64_t offset_;
+    std::size_t raw_bytes_;
+    std::size_t stored_bytes_;
+    bool write_error_;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,120 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file CommandLineOptions.hh
+/// \brief Definition of the CommandLineOptions class
+
+#ifndef CommandLineOptions_h
+#define CommandLineOptions_h 1
+
+#include "globals.hh"
+#include "G4RunManagerFactory.hh"
+
+#include <vector>
+
+/// Command line options of the proton_pol executable
+///
+/// proton_pol [options] [macro]
+///  -m, --macro file        macro executed before the run
+///  -r, --run-manager type  serial, mt, tasking or default
+///  -t, --threads n         number of worker threads
+///  -n, --events n          number of events (/run/beamOn n after the macro)
+///  -s, --seed n            fixed random seed
+///      --event-seeding     seed every event from (seed, event ID)
+///      --replay-event id   replay one event with event seeding and tracking verbose
+///  -p, --momentum p        beam momentum in MeV/c
+///  -l, --physics name      physics list (default QGSP_BERT_HP)
+///  -o, --output name       base name of the event output files
+///      --scaling n         thread-scaling benchmark with 1,2,4,...,n threads
+///      --processes n       fork n processes after initialization (batch only)
+///      --checkpoint dir    checkpointed job, state in dir (batch only)
+///      --checkpoint-every n     events per checkpoint (default events/10)
+///      --checkpoint-minutes m   minutes per checkpoint
+///      --resume            resume the checkpointed job from dir (batch only)
+///      --timing-report f   file for the run timing report
+///      --startup-report f  file for the startup phase timing report (JSON)
+///  -h, --help              print this message
+///
+/// Without macro, events and scaling the interactive session is started.
+
+class CommandLineOptions
+{
+  public:
+    CommandLineOptions();
+    ~CommandLineOptions();
+
+    G4bool Parse(G4int argc, char** argv);
+    void PrintUsage(const char* program) const;
+
+    G4bool IsInteractive() const;
+    G4RunManagerType GetRunManagerType() const;
+    std::vector<G4String> GetCommands() const;
+
+    inline const G4String& GetMacro() const { return macro_; }
+    inline const G4String& GetRunManagerName() const { return run_manager_; }
+    inline G4int GetThreads() const { return threads_; }
+    inline G4int GetEvents() const { return events_; }
+    inline G4long GetSeed() const { return seed_; }
+    inline G4bool GetEventSeeding() const { return event_seeding_; }
+    inline G4int GetReplayEvent() const { return replay_event_; }
+    inline G4double GetMomentum() const { return momentum_; }
+    inline const G4String& GetPhysicsList() const { return physics_list_; }
+    inline const G4String& GetOutput() const { return output_; }
+    inline G4int GetScalingThreads() const { return scaling_threads_; }
+    inline G4int GetProcesses() const { return processes_; }
+    inline const G4String& GetCheckpoint() const { return checkpoint_; }
+    inline G4long GetCheckpointEvents() const { return checkpoint_events_; }
+    inline G4double GetCheckpointMinutes() const { return checkpoint_minutes_; }
+    inline G4bool GetResume() const { return resume_; }
+    inline const G4String& GetTimingReport() const { return timing_report_; }
+    inline const G4String& GetStartupReport() const { return startup_report_; }
+    inline G4bool GetHelp() const { return help_; }
+
+  private:
+    G4String macro_;
+    G4String run_manager_;
+    G4int threads_;
+    G4int events_;
+    G4long seed_;
+    G4bool event_seeding_;
+    G4int replay_event_;
+    G4double momentum_;
+    G4String physics_list_;
+    G4String output_;
+    G4int scaling_threads_;
+    G4int processes_;
+    G4String checkpoint_;
+    G4long checkpoint_events_;
+    G4double checkpoint_minutes_;
+    G4bool resume_;
+    G4String timing_report_;
+    G4String startup_report_;
+    G4bool help_;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -42,4 +42,13 @@ constexpr G4int kNofHadColumns = 10;
 constexpr G4int kNofHadRows = 2;
 constexpr G4int kNofHadCells = kNofHadColumns * kNofHadRows;
 
+// drift chambers
+constexpr G4int kTotalDCs = 2;
+constexpr G4int kDCINId = 0;
+constexpr G4int kDCOUTId = 1;
+
+// theta window of the asymmetry analysis (deg)
+constexpr G4double kAnalysisThetaMin = 10.;
+constexpr G4double kAnalysisThetaMax = 20.;
+
 #endif
@@ -60,13 +60,20 @@ class DetectorConstruction : public G4VUserDetectorConstruction
     virtual void ConstructSDandField();
 
     void ConstructMaterials();
+
+    void SetHitPolicy(const G4String& policy);
+    void SetMaxHits(G4int max_hits);
+    void SetBiasingFactor(G4double factor);
     
   private:
+    void DefineCommands();
+
     G4GenericMessenger* fMessenger;
     
     //static G4ThreadLocal MagneticField* fMagneticField;
     //static G4ThreadLocal G4FieldManager* fFieldMgr;
     
+    G4LogicalVolume* target_logical_;
     G4LogicalVolume* dcin_wireplane_logical_;
     G4LogicalVolume* dcout_wireplane_logical_;
 
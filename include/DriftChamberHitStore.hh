@@ -0,0 +1,124 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file DriftChamberHitStore.hh
+/// \brief Definition of the DriftChamberHitStore class
+
+#ifndef DriftChamberHitStore_h
+#define DriftChamberHitStore_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "Constants.hh"
+
+#include <vector>
+
+/// Drift chamber hit store
+///
+/// Structure-of-arrays store of the hits of one drift chamber in the
+/// current event, one instance per chamber and per thread.
+/// Positions, momenta and times are packed as floats; the columns are
+/// cleared (not freed) at the beginning of each event, so after the first
+/// events no allocation happens in the event loop.
+///
+/// DriftChamberSD writes into the store and EventAction reads the columns
+/// in place. DriftChamberHit objects are only created for visualization.
+
+class DriftChamberHitStore
+{
+  public:
+    static DriftChamberHitStore* Instance(G4int chamber_id);
+
+    inline void Clear();
+    inline void Add(const G4ThreeVector& position, const G4ThreeVector& momentum,
+                    G4double time, G4int track_id, G4int parent_id, G4int particle_id);
+
+    inline std::size_t GetSize() const { return time_.size(); }
+    inline G4ThreeVector GetPosition(std::size_t i) const 
+    { return G4ThreeVector(x_[i], y_[i], z_[i]); }
+    inline G4ThreeVector GetMomentum(std::size_t i) const 
+    { return G4ThreeVector(px_[i], py_[i], pz_[i]); }
+
+    // columns
+    inline const std::vector<G4float>& GetX() const { return x_; }
+    inline const std::vector<G4float>& GetY() const { return y_; }
+    inline const std::vector<G4float>& GetZ() const { return z_; }
+    inline const std::vector<G4float>& GetPx() const { return px_; }
+    inline const std::vector<G4float>& GetPy() const { return py_; }
+    inline const std::vector<G4float>& GetPz() const { return pz_; }
+    inline const std::vector<G4float>& GetTime() const { return time_; }
+    inline const std::vector<G4int>& GetTrackID() const { return track_id_; }
+    inline const std::vector<G4int>& GetParentID() const { return parent_id_; }
+    inline const std::vector<G4int>& GetParticleID() const { return particle_id_; }
+
+  private:
+    DriftChamberHitStore();
+    ~DriftChamberHitStore();
+
+    std::vector<G4float> x_, y_, z_;
+    std::vector<G4float> px_, py_, pz_;
+    std::vector<G4float> time_;
+    std::vector<G4int> track_id_;
+    std::vector<G4int> parent_id_;
+    std::vector<G4int> particle_id_;
+
+    static G4ThreadLocal DriftChamberHitStore* fgInstances[kTotalDCs];
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void DriftChamberHitStore::Clear()
+{
+  x_.clear(); y_.clear(); z_.clear();
+  px_.clear(); py_.clear(); pz_.clear();
+  time_.clear();
+  track_id_.clear();
+  parent_id_.clear();
+  particle_id_.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void DriftChamberHitStore::Add(const G4ThreeVector& position, 
+                                      const G4ThreeVector& momentum,
+                                      G4double time, G4int track_id, 
+                                      G4int parent_id, G4int particle_id)
+{
+  x_.push_back(position.x());
+  y_.push_back(position.y());
+  z_.push_back(position.z());
+  px_.push_back(momentum.x());
+  py_.push_back(momentum.y());
+  pz_.push_back(momentum.z());
+  time_.push_back(time);
+  track_id_.push_back(track_id);
+  parent_id_.push_back(parent_id);
+  particle_id_.push_back(particle_id);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -33,25 +33,65 @@
 #include "G4VSensitiveDetector.hh"
 
 #include "DriftChamberHit.hh"
+#include "DriftChamberHitStore.hh"
 
 class G4Step;
 class G4HCofThisEvent;
 class G4TouchableHistory;
+class G4Track;
+
+/// Hit recording policy of the drift chambers
+///
+/// - kRecordAllSteps      : one hit per charged step (default)
+/// - kRecordFirstCrossing : only the first step of each track
+/// - kRecordPrimaryOnly   : only the steps of primary tracks
+/// - kRecordFirstN        : only the first N steps of the event in the chamber
+
+enum DriftChamberRecordPolicy {
+  kRecordAllSteps,
+  kRecordFirstCrossing,
+  kRecordPrimaryOnly,
+  kRecordFirstN
+};
 
 /// Drift chamber sensitive detector
+///
+/// The recording policy is shared by all drift chambers and threads;
+/// it is changed only between runs (PreInit/Idle) by DetectorConstruction.
+///
+/// Hits are written into the DriftChamberHitStore of the chamber; the
+/// DriftChamberHit collection is only filled when visualization is active.
 
 class DriftChamberSD : public G4VSensitiveDetector
 {
   public:
-    DriftChamberSD(G4String name);
+    DriftChamberSD(G4String name, G4int chamber_id);
     virtual ~DriftChamberSD();
     
     virtual void Initialize(G4HCofThisEvent*HCE);
     virtual G4bool ProcessHits(G4Step* aStep, G4TouchableHistory* ROhist);
+    virtual void EndOfEvent(G4HCofThisEvent*HCE);
+
+    static void SetRecordPolicy(DriftChamberRecordPolicy policy) { fgRecordPolicy = policy; }
+    static DriftChamberRecordPolicy GetRecordPolicy() { return fgRecordPolicy; }
+    static void SetMaxHitsPerChamber(G4int max_hits) { fgMaxHitsPerChamber = max_hits; }
+    static G4int GetMaxHitsPerChamber() { return fgMaxHitsPerChamber; }
     
   private:
+    G4bool AcceptStep(const G4Track* track);
+
     DriftChamberHitsCollection* fHitsCollection;
     G4int fHCID;
+    DriftChamberHitStore* hit_store_;
+
+    // charged steps seen in this event (hits with kRecordAllSteps)
+    G4int charged_steps_;
+    // track recorded last in this event (kRecordFirstCrossing); the steps
+    // of a track are processed before the next track starts
+    G4int last_recorded_track_;
+
+    static DriftChamberRecordPolicy fgRecordPolicy;
+    static G4int fgMaxHitsPerChamber;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -33,18 +33,18 @@
 
 #include "G4UserEventAction.hh"
 #include "globals.hh"
+#include "Constants.hh"
 
 #include <vector>
 #include <array>
+#include <chrono>
+
+class DriftChamberHitStore;
 
 // named constants
-const G4int kTotalDCs = 2;
 const G4int kTotalHistogramsForDC = 3;
 const G4int kTotalHistogramsForAnalysis = 6;
 
-const G4int kDCINId = 0;
-const G4int kDCOUTId = 1;
-
 /// Event action
 
 class EventAction : public G4UserEventAction
@@ -56,12 +56,25 @@ public:
     virtual void BeginOfEventAction(const G4Event*);
     virtual void EndOfEventAction(const G4Event*);
 
+    // start of the busy time of the event, called by PrimaryGeneratorAction
+    // (Geant4 generates the primaries before BeginOfEventAction)
+    inline void StartEventTimer() { event_start_ = std::chrono::steady_clock::now(); }
+
+    // event weight : weight of the primary proton at the end of its track
+    // (occurrence biasing), set by TrackingAction
+    inline void SetPrimaryWeight(G4double weight) { primary_weight_ = weight; }
+
 private:
-    // hit collections Ids
-    std::array<G4int, kTotalDCs> dc_hitcollection_id_;
+    // hit stores of this thread
+    std::array<DriftChamberHitStore*, kTotalDCs> dc_hit_store_;
     // histograms Ids
     std::array<std::array<G4int, kTotalDCs>, kTotalHistogramsForDC> dc_histogram_id_;
     std::array<G4int, kTotalHistogramsForAnalysis> analysis_histogram_id_;
+    // start of the current event (busy time accounting)
+    std::chrono::steady_clock::time_point event_start_;
+    G4double primary_weight_;
+    // current print progress of the run manager
+    G4long print_progress_;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
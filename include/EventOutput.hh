@@ -0,0 +1,100 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EventOutput.hh
+/// \brief Definition of the EventOutput class
+
+#ifndef EventOutput_h
+#define EventOutput_h 1
+
+#include "globals.hh"
+#include "EventRecord.hh"
+#include "AsyncEventWriter.hh"
+
+class G4GenericMessenger;
+class ColumnarWriter;
+
+/// Event output, one instance per thread
+///
+/// Writes the EventRecord of each event to the selected backends:
+/// - root     : the EventTree ntuple of the analysis manager (default)
+/// - columnar : one native columnar file per thread and run,
+///              <file>_run<run>_t<thread>.ppcol (see ColumnarFormat.hh)
+/// - both
+/// - none     : no event output (histograms and asymmetries only)
+///
+/// With /proton_pol/output/async true the columnar records are pushed into
+/// a lock-free ring buffer of the thread and written by the writer thread
+/// of AsyncEventWriter (queueDepth records, backPressure block or drop);
+/// the queue statistics are printed at the end of run. The root ntuple is
+/// always filled by the thread itself (the analysis manager is per thread).
+///
+/// The instance of each thread is created by its RunAction, so the
+/// /proton_pol/output/ commands are available and broadcast on all threads.
+
+class EventOutput
+{
+  public:
+    static EventOutput* Instance();
+    ~EventOutput();
+
+    void OpenRun(G4int run_id);
+    void Write(const EventRecord& record);
+    void CloseRun();
+
+    // one row of the columnar output
+    static void FillColumnar(ColumnarWriter& writer, const EventRecord& record);
+
+    inline G4bool IsRootEnabled() const 
+    { return format_ == "root" || format_ == "both"; }
+    inline G4bool IsColumnarEnabled() const 
+    { return format_ == "columnar" || format_ == "both"; }
+
+  private:
+    EventOutput();
+
+    void DefineCommands();
+    void WriteRoot(const EventRecord& record);
+    void WriteColumnar(const EventRecord& record);
+    void PrintQueueStatistics() const;
+
+    G4GenericMessenger* messenger_;
+    G4String format_;
+    G4String columnar_file_;
+    G4String compression_;
+    G4int block_rows_;
+    ColumnarWriter* columnar_writer_;
+    G4bool async_;
+    G4int queue_depth_;
+    G4String back_pressure_;
+    AsyncEventWriter::Channel* channel_;
+
+    static G4ThreadLocal EventOutput* fgInstance;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,56 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EventRecord.hh
+/// \brief Definition of the EventRecord structure
+
+#ifndef EventRecord_h
+#define EventRecord_h 1
+
+#include "globals.hh"
+
+/// Event record
+///
+/// Fixed-size summary of one event as written to the output
+/// (the columns of the EventTree ntuple and of the columnar files).
+/// Positions are in mm and momenta in MeV; the DCIN/DCOUT values are
+/// zero when the chamber has no hit. The weight is the weight of the
+/// primary proton at the end of its track (1 without biasing).
+
+struct EventRecord
+{
+  G4int dcin_nhit;
+  G4float dcin_position[3];
+  G4float dcin_momentum[3];
+  G4int dcout_nhit;
+  G4float dcout_position[3];
+  G4float dcout_momentum[3];
+  G4float weight;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,96 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EventSkim.hh
+/// \brief Definition of the EventSkim class
+
+#ifndef EventSkim_h
+#define EventSkim_h 1
+
+#include "globals.hh"
+#include "EventRecord.hh"
+
+#include <functional>
+#include <vector>
+
+class G4GenericMessenger;
+class Run;
+
+/// Event skim, one instance per thread
+///
+/// Selects the events written by EventOutput (histograms and asymmetries
+/// still see every event). The rules are set with the /proton_pol/skim/
+/// commands:
+/// - requireDCIN, requireDCOUT : a hit in the chamber
+/// - particle                  : particle of the first DCOUT hit
+/// - thetaMin, thetaMax        : polar angle of the DCOUT momentum
+/// - momentumMin, momentumMax  : DCOUT momentum (max 0 : no upper limit)
+/// and compiled at the start of each run into a chain of predicates,
+/// containing only the enabled rules. The events passing each stage are
+/// counted in Run (cutflow), merged and printed by the master.
+
+class EventSkim
+{
+  public:
+    static EventSkim* Instance();
+    ~EventSkim();
+
+    // builds the predicate chain from the current rules
+    void Compile();
+
+    // applies the chain and fills the cutflow of the run
+    G4bool Select(const EventRecord& record, G4int dcout_particle, Run* run) const;
+
+    // name of each cutflow stage, stage 0 is all events
+    std::vector<G4String> GetStageNames() const;
+
+  private:
+    EventSkim();
+
+    void DefineCommands();
+
+    using Predicate = std::function<G4bool(const EventRecord&, G4int)>;
+    struct Cut {
+      G4String name;
+      Predicate pass;
+    };
+
+    G4GenericMessenger* messenger_;
+    G4bool require_dcin_;
+    G4bool require_dcout_;
+    G4String particle_;
+    G4double theta_min_;
+    G4double theta_max_;
+    G4double momentum_min_;
+    G4double momentum_max_;
+    std::vector<Cut> cuts_;
+
+    static G4ThreadLocal EventSkim* fgInstance;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,82 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ForkedJob.hh
+/// \brief Definition of the ForkedJob class
+
+#ifndef ForkedJob_h
+#define ForkedJob_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class CommandLineOptions;
+
+/// Fork-after-initialization multi-process job (--processes n)
+///
+/// The (serial) application is initialized once, including the physics
+/// tables (/run/beamOn 0), then n child processes are forked which share
+/// the initialized geometry and tables copy-on-write. Every child runs its
+/// share of the events with event seeding from the same run seed and its
+/// own range of event IDs (/proton_pol/run/eventOffset), so the job
+/// reproduces the events of a single event-seeded run. The child outputs
+///   <file>_p<i>.root, <file>_p<i>_asymmetry.state, 
+///   <columnar>_p<i>_run<run>_t0.ppcol, <file>_p<i>.log
+/// are merged when all children are done: the histograms into <file>.root
+/// in this process (G4AnalysisReader, no ROOT installation needed; the
+/// ntuples stay in the files of the children), the other outputs by
+/// execute-proton_pol_merge.
+/// The live histograms of a child are in the segment <name>_p<i>, removed
+/// when the child exits.
+
+class ForkedJob
+{
+  public:
+    ForkedJob(const G4String& program, const CommandLineOptions& options);
+    ~ForkedJob();
+
+    G4int Execute();
+
+  private:
+    G4int RunChild(G4int process, G4int first_event, G4int events) const;
+    G4bool Merge() const;
+    G4bool MergeHistograms(const G4String& output, 
+                           const std::vector<G4String>& inputs) const;
+    G4bool RunMerge(const G4String& output, const std::vector<G4String>& inputs,
+                    const G4String& flags = "") const;
+
+    G4String program_;
+    const CommandLineOptions& options_;
+    G4String file_;
+    G4String columnar_file_;
+    G4String asymmetry_file_;
+    G4String polarization_;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
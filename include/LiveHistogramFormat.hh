@@ -0,0 +1,100 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file LiveHistogramFormat.hh
+/// \brief Definition of the proton_pol live histogram segment layout
+///
+/// POSIX shared-memory segment (default /proton_pol_live) with the live
+/// histograms of a running job, written by LiveHistograms and read by
+/// LiveHistogramReader. All offsets are in bytes from the segment start.
+///
+///   segment := header
+///              nhistograms x LiveHistogramInfo
+///              nslots x slot               (64-byte aligned)
+///   slot    := LiveSlotHeader              (sequence, events)
+///              nhistograms x double        entries
+///              nbins x double              sum of weights of every bin,
+///                                          histogram by histogram,
+///                                          H2 bins x-major
+///
+/// Every slot has one writer, a thread of the job (slot 0 : master or
+/// sequential mode, slot i+1 : worker i), which never blocks: the slot is
+/// versioned like a seqlock. The writer makes the sequence odd, copies
+/// its bins and makes it even again; a reader copies a slot between two
+/// reads of an even and unchanged sequence, retrying otherwise, and sums
+/// the slots. The generation of the header changes at every run.
+///
+/// This header and LiveHistogramReader do not depend on Geant4 and are
+/// built into the proton_pol_live library.
+
+#ifndef LiveHistogramFormat_h
+#define LiveHistogramFormat_h 1
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+constexpr char kLiveMagic[8] = { 'P','P','L','I','V','E','0','1' };
+constexpr std::uint32_t kLiveVersion = 1;
+constexpr std::size_t kLiveNameLength = 48;
+
+struct LiveHeader
+{
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t nhistograms;
+  std::uint32_t nslots;
+  std::uint32_t reserved;
+  std::uint64_t nbins;           // bins of all histograms
+  std::uint64_t slot_offset;     // first slot
+  std::uint64_t slot_size;       // bytes per slot
+  std::atomic<std::uint64_t> generation;
+};
+
+struct LiveHistogramInfo
+{
+  char name[kLiveNameLength];
+  std::uint32_t dimension;       // 1 or 2
+  std::uint32_t nx, ny;          // ny = 1 for H1
+  std::uint32_t reserved;
+  double xmin, xmax, ymin, ymax;
+  std::uint64_t first_bin;       // index in the bins of a slot
+};
+
+struct alignas(64) LiveSlotHeader
+{
+  std::atomic<std::uint64_t> sequence;
+  std::uint64_t events;
+};
+
+inline std::size_t LiveAlign(std::size_t size)
+{
+  return (size + 63) & ~std::size_t(63);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,92 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file LiveHistogramReader.hh
+/// \brief Definition of the LiveHistogramReader class
+
+#ifndef LiveHistogramReader_h
+#define LiveHistogramReader_h 1
+
+#include "LiveHistogramFormat.hh"
+
+#include <string>
+#include <vector>
+
+/// Reader of the live histogram segment (see LiveHistogramFormat.hh)
+///
+/// The segment is mapped read-only; Read() takes a consistent copy of
+/// every slot (seqlock) and sums them. It never blocks the job.
+///
+///   LiveHistogramReader reader;
+///   reader.Open("/proton_pol_live");
+///   while (reader.Read()) {
+///     auto theta = reader.GetHistogramIndex("analysis_theta");
+///     ... reader.GetBins(theta)[i] ...
+///   }
+
+class LiveHistogramReader
+{
+  public:
+    LiveHistogramReader();
+    ~LiveHistogramReader();
+
+    bool Open(const std::string& name);
+    void Close();
+    bool IsOpen() const { return data_ != nullptr; }
+
+    // sums the slots, false when the segment is not valid
+    bool Read();
+
+    std::uint64_t GetGeneration() const { return generation_; }
+    std::uint64_t GetEvents() const { return events_; }
+    std::size_t GetNumberOfHistograms() const { return infos_.size(); }
+    const LiveHistogramInfo& GetInfo(std::size_t histogram) const { return infos_[histogram]; }
+    // -1 if there is no histogram with this name
+    int GetHistogramIndex(const std::string& name) const;
+    double GetEntries(std::size_t histogram) const { return entries_[histogram]; }
+    const double* GetBins(std::size_t histogram) const
+    { return bins_.data() + infos_[histogram].first_bin; }
+
+  private:
+    bool ReadSlot(std::size_t slot, std::vector<double>& buffer, std::uint64_t& events) const;
+
+    const unsigned char* data_;
+    std::size_t size_;
+    std::uint64_t generation_;
+    std::uint64_t events_;
+    // layout of the current generation
+    std::uint64_t nbins_;
+    std::uint64_t nslots_;
+    std::uint64_t slot_offset_;
+    std::uint64_t slot_size_;
+    std::vector<LiveHistogramInfo> infos_;
+    std::vector<double> entries_;
+    std::vector<double> bins_;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,100 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file LiveHistograms.hh
+/// \brief Definition of the LiveHistograms class
+
+#ifndef LiveHistograms_h
+#define LiveHistograms_h 1
+
+#include "globals.hh"
+#include "LiveHistogramFormat.hh"
+
+#include <vector>
+
+class G4GenericMessenger;
+class G4Run;
+
+/// Live histograms in a POSIX shared-memory segment, one instance per
+/// process
+///
+/// The analysis_* histograms and the dc*_hitposition_xy histograms of
+/// every thread which processes events are copied every
+/// /proton_pol/live/events events, and at the end of run, into the slot of
+/// the thread in the segment /proton_pol/live/name (LiveHistogramFormat.hh).
+/// The copy is versioned like a seqlock: the simulation never waits and
+/// does no I/O, a local viewer (execute-proton_pol_live, or any program
+/// with LiveHistogramReader) maps the segment and sums the slots.
+///
+/// The instance is created by the master RunAction, which owns the
+/// /proton_pol/live/ commands (events 0 : off). The segment is laid out at
+/// the start of every run and removed when the instance is deleted.
+
+class LiveHistograms
+{
+  public:
+    static LiveHistograms* Instance();
+    ~LiveHistograms();
+
+    // event loop side, at the end of every event and of the run
+    void Publish(const G4Run* run, G4bool end_of_run = false);
+
+    // master side, at the start of run
+    void Start();
+
+    const G4String& GetName() const { return name_; }
+    // removes the segment of another process (forked children)
+    static void Remove(const G4String& name);
+
+  private:
+    LiveHistograms();
+
+    struct Histogram {
+      G4int id;
+      G4int dimension;
+    };
+
+    void DefineCommands();
+    G4bool Map(std::size_t size);
+    void Unmap();
+
+    G4GenericMessenger* messenger_;
+    G4String name_;
+    G4int events_;
+
+    std::vector<Histogram> histograms_;
+    unsigned char* data_;
+    std::size_t size_;
+    G4String mapped_name_;
+    G4int owner_;     // process which created the segment
+    std::uint64_t generation_;
+
+    static LiveHistograms* fgInstance;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -46,6 +46,9 @@
 #include "G4VModularPhysicsList.hh"
 #include "globals.hh"
 
+#include <map>
+#include <vector>
+
 class G4VPhysicsConstructor;
 class PhysicsListMessenger;
 class G4PhysListFactoryMessenger;
@@ -61,8 +64,14 @@ public:
 
   virtual void ConstructParticle();
   virtual void ConstructProcess();    
+  virtual void SetCuts();
 
   void AddPhysicsList(const G4String& name);
+  void SetBiasing(G4bool flag);
+  void SetRegionCut(const G4String& region, G4double cut);
+  void SetRegionEmOption(const G4String& region, const G4String& name);
+  void SetPhysicsTableCache(const G4String& directory);
+  void StorePhysicsTableCache();
   void List();
   
 private:
@@ -70,10 +79,20 @@ private:
   void SetBuilderList0(G4bool flagHP = false);
   void SetBuilderList1(G4bool flagHP = false);
   void SetBuilderList2();
+  G4String GetPhysicsConfiguration() const;
+  void SetUpPhysicsTableCache();
 
   G4VPhysicsConstructor*  fEmPhysicsList;
   G4VPhysicsConstructor*  fParticleList;
   std::vector<G4VPhysicsConstructor*>  fHadronPhys;
+  G4VPhysicsConstructor*  fBiasingPhys;
+  std::map<G4String, G4double> fRegionCuts;
+  std::map<G4String, G4String> fRegionEm;
+  std::vector<G4String> fPhysicsNames;
+
+  G4String fCacheDirectory;
+  G4String fCacheEntry;
+  G4bool   fCacheStorePending;
     
   PhysicsListMessenger* fMessenger;
   G4PhysListFactoryMessenger* fFactMessenger;
@@ -51,6 +51,8 @@ class PhysicsList;
 class G4UIcmdWithADoubleAndUnit;
 class G4UIcmdWithAString;
 class G4UIcmdWithoutParameter;
+class G4UIcmdWithABool;
+class G4UIcommand;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -69,6 +71,10 @@ private:
     
   G4UIcmdWithAString*        fPListCmd;
   G4UIcmdWithoutParameter*   fListCmd;  
+  G4UIcmdWithABool*          fBiasingCmd;
+  G4UIcommand*               fRegionCutCmd;
+  G4UIcommand*               fRegionEmCmd;
+  G4UIcmdWithAString*        fCacheCmd;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
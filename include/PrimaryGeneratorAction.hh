@@ -37,6 +37,7 @@ class G4ParticleGun;
 class G4GenericMessenger;
 class G4Event;
 class G4ParticleDefinition;
+class EventAction;
 
 /// Primary generator
 ///
@@ -45,12 +46,13 @@ class G4ParticleDefinition;
 /// - the initial momentum and angle
 /// - the momentum and angle spreads
 /// - random selection of a particle type from proton, kaon+, pi+, muon+, e+ 
+/// The busy time of the event (EventAction) starts here.
 
 
 class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 {
   public:
-    PrimaryGeneratorAction();
+    PrimaryGeneratorAction(EventAction* event_action);
     virtual ~PrimaryGeneratorAction();
     
     virtual void GeneratePrimaries(G4Event*);
@@ -64,6 +66,7 @@ class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
   private:
     void DefineCommands();
 
+    EventAction* event_action_;
     G4ParticleGun* particlegun_;
     G4GenericMessenger* messenger_;
     G4ParticleDefinition* proton_;
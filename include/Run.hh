@@ -0,0 +1,112 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file Run.hh
+/// \brief Definition of the Run class
+
+#ifndef Run_h
+#define Run_h 1
+
+#include "G4Run.hh"
+#include "globals.hh"
+#include "AsymmetryAccumulator.hh"
+#include "StackingAction.hh"
+#include "SteppingProfile.hh"
+
+#include <array>
+#include <vector>
+
+/// Run class
+///
+/// It accumulates per-thread quantities during a run:
+/// - the wall time spent inside the event loop (busy time)
+/// - the charged steps seen and the hits recorded by the drift chambers
+/// - the tracks killed by each rule of the stacking action
+/// - the events passing each stage of the event skim (cutflow)
+/// - the sum of the event weights of events with a DCOUT hit (biasing)
+/// - the azimuthal asymmetry of the scattered protons (AsymmetryAccumulator)
+/// - the stepping profile (SteppingProfile, when profiling is enabled)
+/// Worker runs are merged into the master run at the end of run, where
+/// the busy time of every worker is kept separately.
+
+class Run : public G4Run
+{
+  public:
+    Run(G4int theta_bins, G4double theta_min, G4double theta_max);
+    virtual ~Run();
+
+    virtual void Merge(const G4Run*);
+
+    inline void AddBusyTime(G4double seconds) { busy_time_ += seconds; }
+    inline G4double GetBusyTime() const { return busy_time_; }
+
+    inline void AddDriftChamberSteps(G4long charged_steps, G4long hits) 
+    { dc_charged_steps_ += charged_steps; dc_hits_ += hits; }
+    inline G4long GetDriftChamberChargedSteps() const { return dc_charged_steps_; }
+    inline G4long GetDriftChamberHits() const { return dc_hits_; }
+
+    inline void AddKilledTrack(StackingRule rule) { ++killed_tracks_[rule]; }
+    inline G4long GetKilledTracks(StackingRule rule) const { return killed_tracks_[rule]; }
+
+    inline void AddCutflow(std::size_t stage) 
+    { if (stage >= cutflow_.size()) cutflow_.resize(stage+1, 0); ++cutflow_[stage]; }
+    inline G4long GetCutflow(std::size_t stage) const 
+    { return stage < cutflow_.size() ? cutflow_[stage] : 0; }
+
+    inline void AddWeight(G4double weight) 
+    { ++weighted_events_; sum_weights_ += weight; sum_weights2_ += weight*weight; }
+    inline G4long GetWeightedEvents() const { return weighted_events_; }
+    inline G4double GetSumOfWeights() const { return sum_weights_; }
+    inline G4double GetSumOfWeights2() const { return sum_weights2_; }
+
+    inline AsymmetryAccumulator& GetAsymmetry() { return asymmetry_; }
+    inline const AsymmetryAccumulator& GetAsymmetry() const { return asymmetry_; }
+
+    inline SteppingProfile& GetSteppingProfile() { return stepping_profile_; }
+    inline const SteppingProfile& GetSteppingProfile() const { return stepping_profile_; }
+
+    // filled on master by Merge(), empty in sequential mode
+    inline const std::vector<G4double>& GetWorkerBusyTimes() const { return worker_busy_times_; }
+    inline const std::vector<G4int>& GetWorkerEvents() const { return worker_events_; }
+
+  private:
+    G4double busy_time_;
+    G4long dc_charged_steps_;
+    G4long dc_hits_;
+    std::array<G4long, kTotalStackingRules> killed_tracks_;
+    std::vector<G4long> cutflow_;
+    G4long weighted_events_;
+    G4double sum_weights_;
+    G4double sum_weights2_;
+    AsymmetryAccumulator asymmetry_;
+    SteppingProfile stepping_profile_;
+    std::vector<G4double> worker_busy_times_;
+    std::vector<G4int> worker_events_;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
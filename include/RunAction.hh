@@ -33,9 +33,24 @@
 #include "G4UserRunAction.hh"
 #include "globals.hh"
 
+#include <chrono>
+
 class G4Run;
+class G4GenericMessenger;
 
 /// Run action class
+///
+/// User can select
+/// - a fixed random seed (0 means a time based seed)
+/// - event seeding: the random engine is reseeded at every event from a
+///   counter-based hash of (run seed, event ID), so that results do not
+///   depend on the number of threads and no engine state files are written
+/// - the event ID replayed by every event of the next runs (event seeding)
+/// - an offset of the seeded event IDs, the event share of one process of
+///   a forked job
+/// - a file to which the master writes the run timing report
+/// - the theta binning, beam polarization and output files (results and
+///   raw sums) of the streaming asymmetry estimator
 
 class RunAction : public G4UserRunAction
 {
@@ -43,10 +58,37 @@ class RunAction : public G4UserRunAction
     RunAction();
     virtual ~RunAction();
 
+    virtual G4Run* GenerateRun();
     virtual void BeginOfRunAction(const G4Run*);
     virtual void   EndOfRunAction(const G4Run*);
 
+    void SeedEvent(G4int event_id) const;
+
   private:
+    void DefineCommands();
+    void PrintRunSummary(const G4Run*, G4double wall_time) const;
+    void WriteTimingReport(const G4Run*, G4double wall_time) const;
+    void PrintCutflow(const G4Run*) const;
+    void PrintAsymmetry(const G4Run*) const;
+
+    G4GenericMessenger* messenger_;
+    G4GenericMessenger* asymmetry_messenger_;
+    G4long random_seed_;
+    G4bool event_seeding_;
+    G4int replay_event_;
+    G4int event_offset_;
+    G4String timing_report_;
+    G4int theta_bins_;
+    G4double theta_min_;
+    G4double theta_max_;
+    G4double beam_polarization_;
+    G4String asymmetry_file_;
+    G4String asymmetry_state_file_;
+    std::chrono::steady_clock::time_point run_start_;
+
+    // run seed of event seeding, chosen by the master at the start of run
+    // (before the workers start their run)
+    static G4long fgEventSeedingRunSeed;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,120 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file Snapshot.hh
+/// \brief Definition of the Snapshot class
+
+#ifndef Snapshot_h
+#define Snapshot_h 1
+
+#include "globals.hh"
+#include "Analysis.hh"
+#include "AsymmetryAccumulator.hh"
+
+#include "tools/histo/h1d"
+#include "tools/histo/h2d"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class G4GenericMessenger;
+class Run;
+
+/// In-flight snapshots of the histograms and the asymmetry, one instance
+/// per process
+///
+/// Every thread which processes events publishes copies of its histograms
+/// and of its asymmetry accumulator every /proton_pol/snapshot/events
+/// events into a double-buffered slot: the copy is made into the back
+/// buffer without lock, then the buffers are swapped under the lock of the
+/// slot. While a run is in progress a background thread merges the front
+/// buffers of all threads every /proton_pol/snapshot/interval and replaces
+/// (write and rename)
+/// - <file>.csv        : the asymmetry per theta bin (AsymmetryAccumulator)
+/// - <file>_histos.txt : the H1 and H2 histograms, bin by bin
+/// so that a long job can be checked, and killed, before its end of run.
+///
+/// The instance is created by the master RunAction, which owns the
+/// /proton_pol/snapshot/ commands (interval 0 : off).
+
+class Snapshot
+{
+  public:
+    static Snapshot* Instance();
+    ~Snapshot();
+
+    // event loop side, at the end of every event
+    void Publish(const Run* run);
+
+    // master side, at the start and the end of run
+    void Start(G4double polarization);
+    void Stop();
+
+  private:
+    Snapshot();
+
+    struct Buffer {
+      G4long events = 0;
+      std::vector<tools::histo::h1d> h1;
+      std::vector<tools::histo::h2d> h2;
+      AsymmetryAccumulator asymmetry;
+    };
+    struct Slot {
+      std::mutex mutex;
+      Buffer buffers[2];
+      G4int front = 0;
+      G4bool valid = false;
+    };
+
+    void DefineCommands();
+    void Write();
+    G4bool WriteHistograms(const G4String& path, const Buffer& merged) const;
+
+    G4GenericMessenger* messenger_;
+    G4double interval_;
+    G4int events_;
+    G4String file_;
+    G4double polarization_;
+
+    std::vector<std::unique_ptr<Slot>> slots_;
+    std::vector<G4String> h1_names_;
+    std::vector<G4String> h2_names_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable stop_condition_;
+    G4bool stop_;
+
+    static Snapshot* fgInstance;
+    static G4ThreadLocal Slot* fgSlot;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
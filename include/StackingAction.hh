@@ -0,0 +1,80 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StackingAction.hh
+/// \brief Definition of the StackingAction class
+
+#ifndef StackingAction_h
+#define StackingAction_h 1
+
+#include "G4UserStackingAction.hh"
+#include "globals.hh"
+
+class G4GenericMessenger;
+
+/// Track culling rules of the stacking action (counted in Run)
+enum StackingRule {
+  kKillNeutral,     // neutral secondaries (ignored by DriftChamberSD)
+  kKillLowEnergy,   // charged secondaries below the energy threshold
+  kKillAcceptance,  // charged secondaries outside the DCOUT cone
+  kKillLateTime,    // secondaries created after the time cut
+  kTotalStackingRules
+};
+
+/// Stacking action
+///
+/// Secondaries which cannot produce a drift chamber hit are killed
+/// before they are tracked. User can select
+/// - killing of neutral secondaries (off by default: their charged
+///   secondaries, e.g. recoil protons of neutrons, can reach DCOUT)
+/// - a kinetic energy threshold of charged secondaries (0 : off)
+/// - the half opening angle of the cone along +z which contains
+///   DCOUT; charged secondaries heading outside are killed (180 deg : off)
+/// - a global time cut (0 : off)
+/// Primary tracks are never killed.
+
+class StackingAction : public G4UserStackingAction
+{
+  public:
+    StackingAction();
+    virtual ~StackingAction();
+
+    virtual G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* track);
+
+  private:
+    void DefineCommands();
+    G4ClassificationOfNewTrack Kill(StackingRule rule) const;
+
+    G4GenericMessenger* messenger_;
+    G4bool kill_neutrals_;
+    G4double energy_threshold_;
+    G4double acceptance_angle_;
+    G4double time_cut_;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
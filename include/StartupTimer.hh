@@ -0,0 +1,98 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StartupTimer.hh
+/// \brief Definition of the StartupTimer class
+
+#ifndef StartupTimer_h
+#define StartupTimer_h 1
+
+#include "globals.hh"
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/// Startup timer
+///
+/// Records the wall time of the initialization phases on master and on
+/// every worker thread. Phases are timed explicitly (Start/Stop or a Scope
+/// object) or, after ObserveStates() was called on a thread, from the
+/// application state transitions of that thread:
+/// - Initialize : PreInit -> Init -> Idle (/run/initialize, geometry and
+///   physics construction)
+/// - RunInitialization : first Idle -> Init -> Idle of a run (physics
+///   tables, hadronic data loading)
+/// The report is written in JSON at the end of the job, with the start
+/// of each phase relative to the creation of the timer (job start).
+
+class StartupTimer
+{
+  public:
+    static StartupTimer* Instance();
+
+    // phases are identified by name and thread;
+    // stopping a phase which was not started is ignored
+    void Start(const G4String& phase);
+    void Stop(const G4String& phase);
+    void ObserveStates();
+
+    G4bool Write(const G4String& path) const;
+
+    class Scope
+    {
+      public:
+        explicit Scope(const G4String& phase) : phase_(phase)
+        { StartupTimer::Instance()->Start(phase_); }
+        ~Scope() { StartupTimer::Instance()->Stop(phase_); }
+      private:
+        G4String phase_;
+    };
+
+  private:
+    StartupTimer();
+    ~StartupTimer();
+
+    G4double GetTime() const;
+
+    struct Record {
+      G4int thread;
+      G4String phase;
+      G4double start;
+      G4double duration;
+    };
+
+    std::chrono::steady_clock::time_point job_start_;
+    std::map<std::pair<G4int, G4String>, G4double> started_;
+    std::vector<Record> records_;
+    mutable std::mutex mutex_;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
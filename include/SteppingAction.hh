@@ -0,0 +1,72 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SteppingAction.hh
+/// \brief Definition of the SteppingAction class
+
+#ifndef SteppingAction_h
+#define SteppingAction_h 1
+
+#include "G4UserSteppingAction.hh"
+#include "globals.hh"
+
+#include <chrono>
+
+class G4GenericMessenger;
+class G4Track;
+
+/// Stepping action
+///
+/// Optional stepping profiler (off by default): fills the SteppingProfile
+/// of the current Run with the steps, track length and sampled time per
+/// (volume, process, particle). Every samplePeriod-th step arms the timer,
+/// and the wall time until the next step of the same track is added to
+/// that step (0 : no timing).
+
+class SteppingAction : public G4UserSteppingAction
+{
+  public:
+    SteppingAction();
+    virtual ~SteppingAction();
+
+    virtual void UserSteppingAction(const G4Step* step);
+
+  private:
+    void DefineCommands();
+
+    G4GenericMessenger* messenger_;
+    G4bool profile_;
+    G4int sample_period_;
+
+    G4int steps_to_sample_;
+    const G4Track* timed_track_;
+    G4int timed_step_;
+    std::chrono::steady_clock::time_point timed_start_;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
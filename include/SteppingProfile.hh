@@ -0,0 +1,108 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SteppingProfile.hh
+/// \brief Definition of the SteppingProfile class
+
+#ifndef SteppingProfile_h
+#define SteppingProfile_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+class G4VPhysicalVolume;
+class G4VProcess;
+class G4ParticleDefinition;
+
+/// Stepping profile
+///
+/// Steps, track length and sampled step time per (volume, process,
+/// particle). Volumes, processes and particles are numbered on first use
+/// and the entries are kept in a flat table keyed by the packed numbers;
+/// the entry of the previous step is cached. The profile of every thread
+/// is held by its Run and merged by name into the master run.
+
+class SteppingProfile
+{
+  public:
+    struct Entry {
+      G4long steps = 0;
+      G4double length = 0.;
+      G4long time_samples = 0;
+      G4double time = 0.;     // sum of the sampled step times [s]
+    };
+
+    SteppingProfile();
+    ~SteppingProfile();
+
+    inline Entry& GetEntry(const G4VPhysicalVolume* volume, 
+                           const G4VProcess* process,
+                           const G4ParticleDefinition* particle)
+    {
+      if (volume != last_volume_ || process != last_process_ 
+          || particle != last_particle_) {
+        last_volume_ = volume;
+        last_process_ = process;
+        last_particle_ = particle;
+        last_entry_ = &FindEntry(volume, process, particle);
+      }
+      return *last_entry_;
+    }
+
+    void Merge(const SteppingProfile& profile);
+    void Print(std::ostream& output, G4int lines) const;
+    inline G4bool IsEmpty() const { return entries_.empty(); }
+
+  private:
+    enum { kVolume, kProcess, kParticle, kTotalCategories };
+
+    Entry& FindEntry(const G4VPhysicalVolume* volume, 
+                     const G4VProcess* process,
+                     const G4ParticleDefinition* particle);
+    uint64_t GetIndex(G4int category, const void* object);
+    uint64_t GetIndex(G4int category, const G4String& name);
+    inline static uint64_t Pack(uint64_t volume, uint64_t process, uint64_t particle)
+    { return (volume << 42) | (process << 21) | particle; }
+
+    std::unordered_map<uint64_t, Entry> entries_;
+    std::unordered_map<const void*, uint64_t> object_index_[kTotalCategories];
+    std::map<G4String, uint64_t> name_index_[kTotalCategories];
+    std::vector<G4String> names_[kTotalCategories];
+
+    const G4VPhysicalVolume* last_volume_;
+    const G4VProcess* last_process_;
+    const G4ParticleDefinition* last_particle_;
+    Entry* last_entry_;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
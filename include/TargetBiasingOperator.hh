@@ -0,0 +1,90 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file TargetBiasingOperator.hh
+/// \brief Definition of the TargetBiasingOperator class
+
+#ifndef TargetBiasingOperator_h
+#define TargetBiasingOperator_h 1
+
+#include "G4VBiasingOperator.hh"
+
+#include <map>
+
+class G4BOptnChangeCrossSection;
+class G4ParticleDefinition;
+
+/// Occurrence biasing of the primary proton in the target
+///
+/// The cross sections of the wrapped hadronic processes (hadElastic and
+/// protonInelastic, see PhysicsList::SetBiasing) are multiplied by a
+/// common factor for primary protons in the logical volume the operator
+/// is attached to. Geant4 applies the corresponding weight to the track;
+/// the weight of the primary at the end of its track is the event weight
+/// (TrackingAction, EventAction::SetPrimaryWeight).
+///
+/// The factor is shared by all threads and changed between runs only.
+
+class TargetBiasingOperator : public G4VBiasingOperator
+{
+  public:
+    TargetBiasingOperator(const G4String& particle_name);
+    virtual ~TargetBiasingOperator();
+
+    virtual void StartRun();
+
+    static void SetFactor(G4double factor) { fgFactor = factor; }
+    static G4double GetFactor() { return fgFactor; }
+
+  private:
+    virtual G4VBiasingOperation* 
+    ProposeOccurenceBiasingOperation(const G4Track* track,
+                                     const G4BiasingProcessInterface* callingProcess);
+    virtual G4VBiasingOperation* 
+    ProposeFinalStateBiasingOperation(const G4Track*, const G4BiasingProcessInterface*)
+    { return nullptr; }
+    virtual G4VBiasingOperation* 
+    ProposeNonPhysicsBiasingOperation(const G4Track*, const G4BiasingProcessInterface*)
+    { return nullptr; }
+
+    using G4VBiasingOperator::OperationApplied;
+    virtual void OperationApplied(const G4BiasingProcessInterface* callingProcess,
+                                  G4BiasingAppliedCase biasingCase,
+                                  G4VBiasingOperation* occurenceOperationApplied,
+                                  G4double weightForOccurenceInteraction,
+                                  G4VBiasingOperation* finalStateOperationApplied,
+                                  const G4VParticleChange* particleChangeProduced);
+
+    const G4ParticleDefinition* particle_;
+    std::map<const G4BiasingProcessInterface*, G4BOptnChangeCrossSection*> operations_;
+    G4bool setup_;
+
+    static G4double fgFactor;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
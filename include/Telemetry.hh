@@ -0,0 +1,119 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file Telemetry.hh
+/// \brief Definition of the Telemetry class
+
+#ifndef Telemetry_h
+#define Telemetry_h 1
+
+#include "globals.hh"
+#include "G4Threading.hh"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class G4GenericMessenger;
+
+/// Live throughput telemetry, one instance per process
+///
+/// Every thread counts its events, steps, drift chamber hits and killed
+/// tracks in its own cache line of relaxed atomics, so the event loop
+/// shares no data. While a run is in progress a background thread samples
+/// the counters at a fixed wall-clock interval and prints (or appends to a
+/// file) one JSON line with the totals, the resident memory, the events/s
+/// of every thread and the estimated time to the end of run.
+///
+/// The instance is created by the master RunAction, which owns the
+/// /proton_pol/telemetry/ commands (interval, 0 : off by default, and file).
+
+class Telemetry
+{
+  public:
+    static Telemetry* Instance();
+    ~Telemetry();
+
+    // event loop side, each thread updates its own counters
+    inline void AddEvent(G4long hits) 
+    { auto& slot = GetSlot(); Add(slot.events, 1); Add(slot.hits, hits); }
+    inline void AddSteps(G4long steps) { Add(GetSlot().steps, steps); }
+    inline void AddKilledTrack() { Add(GetSlot().killed_tracks, 1); }
+    // the interval is changed between runs only
+    inline G4bool IsEnabled() const { return interval_ > 0.; }
+
+    // master side, at the start and the end of run
+    void Start(G4long events_to_process);
+    void Stop();
+
+  private:
+    Telemetry();
+
+    static const G4int kMaxSlots = 256;
+    struct alignas(64) Slot {
+      std::atomic<G4long> events;
+      std::atomic<G4long> steps;
+      std::atomic<G4long> hits;
+      std::atomic<G4long> killed_tracks;
+    };
+
+    inline Slot& GetSlot()
+    { 
+      // master (sequential mode) : slot 0, worker i : slot i+1
+      auto id = G4Threading::G4GetThreadId() + 1;
+      return slots_[id < kMaxSlots ? id : kMaxSlots-1];
+    }
+    inline static void Add(std::atomic<G4long>& counter, G4long value)
+    { counter.fetch_add(value, std::memory_order_relaxed); }
+
+    void DefineCommands();
+    void Sample(G4bool last);
+    G4double GetResidentMemory() const;
+
+    G4GenericMessenger* messenger_;
+    G4double interval_;
+    G4String file_;
+
+    std::vector<Slot> slots_;
+    std::vector<G4long> last_events_;
+    G4long events_to_process_;
+    std::chrono::steady_clock::time_point run_start_;
+    std::chrono::steady_clock::time_point last_sample_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable stop_condition_;
+    G4bool stop_;
+
+    static Telemetry* fgInstance;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,73 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ThreadScalingBenchmark.hh
+/// \brief Definition of the ThreadScalingBenchmark class
+
+#ifndef ThreadScalingBenchmark_h
+#define ThreadScalingBenchmark_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class CommandLineOptions;
+
+/// Thread-scaling benchmark (--scaling n)
+///
+/// The same fixed-seed workload is run at 1,2,4,...,n threads, each in a
+/// fresh child process of the executable, and the table of
+/// - events/s and speed-up
+/// - parallel efficiency
+/// - mean per-thread idle time
+/// is printed. Child output goes to proton_pol_scaling_<threads>.log.
+
+class ThreadScalingBenchmark
+{
+  public:
+    ThreadScalingBenchmark(const G4String& program, const CommandLineOptions& options);
+    ~ThreadScalingBenchmark();
+
+    G4int Execute();
+
+  private:
+    struct Measurement {
+      G4int threads;
+      G4int events;
+      G4double wall_time;
+      std::vector<G4double> busy_times;
+    };
+
+    G4bool Measure(G4int threads, Measurement& measurement) const;
+    void PrintTable(const std::vector<Measurement>& measurements) const;
+
+    G4String program_;
+    const CommandLineOptions& options_;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
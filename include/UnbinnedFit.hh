@@ -0,0 +1,112 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file UnbinnedFit.hh
+/// \brief Definition of the UnbinnedFit class
+
+#ifndef UnbinnedFit_h
+#define UnbinnedFit_h 1
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/// Unbinned maximum-likelihood fit of the azimuthal distribution of the
+/// scattered protons
+///
+///   f(phi | event) = (1 + sum_j p_j x_j) / 2 pi
+///
+/// where the features x_j of every event (for example A_y(theta) cos(phi)
+/// and sin(phi) for a fit of the beam polarization) are given by the
+/// caller. The model is linear in the parameters p_j, so the negative log
+/// likelihood  - sum_i w_i ln(1 + sum_j p_j x_ij)  is convex and is
+/// minimized by Newton steps (halved while the likelihood does not
+/// improve). Every step is one pass over the events: the events are kept
+/// by partition as float columns, and the partitions are evaluated on
+/// threads in chunks of contiguous events, with loops over a chunk which
+/// the compiler vectorizes. The errors come from the sandwich covariance
+/// H^-1 (sum w^2 g g^T) H^-1, which is H^-1 for unit weights and accounts
+/// for the weights of biased events.
+///
+/// The class does not depend on Geant4.
+
+class UnbinnedFit
+{
+  public:
+    static const std::size_t kMaxParameters = 8;
+
+    UnbinnedFit(const std::vector<std::string>& names, int partitions);
+    ~UnbinnedFit();
+
+    // one writer per partition; features holds one value per parameter
+    void AddEvent(int partition, const double* features, double weight);
+
+    void SetParameter(std::size_t parameter, double value) { parameters_[parameter] = value; }
+    // false if the likelihood cannot be minimized (see GetError())
+    bool Minimize(int max_iterations = 50, double tolerance = 1.e-9);
+
+    std::size_t GetNumberOfParameters() const { return names_.size(); }
+    const std::string& GetName(std::size_t parameter) const { return names_[parameter]; }
+    double GetParameter(std::size_t parameter) const { return parameters_[parameter]; }
+    double GetParameterError(std::size_t parameter) const;
+    double GetCovariance(std::size_t i, std::size_t j) const { return covariance_[i][j]; }
+    double GetMinimum() const { return minimum_; }
+    int GetIterations() const { return iterations_; }
+    std::size_t GetNumberOfEvents() const;
+    double GetSumOfWeights() const;
+    const std::string& GetError() const { return error_; }
+
+  private:
+    struct Partition {
+      std::vector<float> features[kMaxParameters];
+      std::vector<float> weights;
+    };
+    struct Sums {
+      bool valid;
+      double nll;
+      double gradient[kMaxParameters];
+      double hessian[kMaxParameters][kMaxParameters];
+      double scores[kMaxParameters][kMaxParameters];   // sum w^2 x x^T / u^2
+    };
+
+    void Evaluate(const double* parameters, Sums& sums) const;
+    void EvaluatePartition(const Partition& partition, const double* parameters, 
+                           Sums& sums) const;
+    // solution of H x = b and inverse of H, false if H is not positive definite
+    bool Solve(const double (*hessian)[kMaxParameters], const double* b, double* x) const;
+
+    std::vector<std::string> names_;
+    std::vector<Partition> partitions_;
+    std::vector<double> parameters_;
+    std::vector<std::vector<double>> covariance_;
+    double minimum_;
+    int iterations_;
+    std::string error_;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
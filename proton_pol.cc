@@ -31,14 +31,14 @@
 #include "ActionInitialization.hh"
 #include "PhysicsList.hh"
 #include "PhysicsListMessenger.hh"
+#include "CommandLineOptions.hh"
+#include "ThreadScalingBenchmark.hh"
+#include "StartupTimer.hh"
 
-#ifdef G4MULTITHREADED
-#include "G4MTRunManager.hh"
-#else
-#include "G4RunManager.hh"
-#endif
-
+#include "G4RunManagerFactory.hh"
+#include "G4StateManager.hh"
 #include "G4UImanager.hh"
+#include "G4UIcommand.hh"
 #include "FTFP_BERT.hh"
 #include "G4StepLimiterPhysics.hh"
 #include "G4PhysListFactory.hh"
@@ -51,46 +51,97 @@
 
 int main(int argc,char** argv)
 {
-  // Detect interactive mode (if no arguments) and define UI session
+  // Parse the command line
+  //
+  CommandLineOptions options;
+  if ( !options.Parse(argc, argv) || options.GetHelp() ) {
+    options.PrintUsage(argv[0]);
+    return options.GetHelp() ? 0 : 1;
+  }
+
+  // Forked and checkpointed jobs are run by proton_pol_batch only
+  //
+  if ( options.GetProcesses() > 0 || !options.GetCheckpoint().empty() ) {
+    G4cerr << "proton_pol: --processes, --checkpoint and --resume are options"
+           << " of proton_pol_batch" << G4endl;
+    return 1;
+  }
+
+  // Thread-scaling benchmark : runs this executable once per thread count
+  //
+  if ( options.GetScalingThreads() > 0 ) {
+    ThreadScalingBenchmark benchmark(argv[0], options);
+    return benchmark.Execute();
+  }
+
+  // Time the startup phases of the master thread
+  //
+  auto startupTimer = StartupTimer::Instance();
+  startupTimer->ObserveStates();
+
+  // Detect interactive mode (if no macro nor events) and define UI session
   //
   G4UIExecutive* ui = 0;
-  if ( argc == 1 ) {
+  if ( options.IsInteractive() ) {
     ui = new G4UIExecutive(argc, argv);
   }
 
-  // Construct the default run manager
+  // Construct the run manager (serial, MT or task based)
   //
-#ifdef G4MULTITHREADED
-  auto runManager = new G4MTRunManager;
-#else
-  auto runManager = new G4RunManager;
-#endif
+  startupTimer->Start("RunManager");
+  auto runManager 
+    = G4RunManagerFactory::CreateRunManager(options.GetRunManagerType());
+  startupTimer->Stop("RunManager");
+  if ( options.GetThreads() > 0 ) {
+    runManager->SetNumberOfThreads(options.GetThreads());
+  }
 
   // Mandatory user initialization classes
+  startupTimer->Start("UserInitialization");
   runManager->SetUserInitialization(new DetectorConstruction);
 
   auto physicslist = new PhysicsList();
-  physicslist->AddPhysicsList("QGSP_BERT_HP");
+  physicslist->AddPhysicsList(options.GetPhysicsList());
   runManager->SetUserInitialization(physicslist);
 
   // User action initialization
   runManager->SetUserInitialization(new ActionInitialization());
+  startupTimer->Stop("UserInitialization");
 
   // Visualization manager construction
   auto visManager = new G4VisExecutive;
   // G4VisExecutive can take a verbosity argument - see /vis/verbose guidance.
   // G4VisManager* visManager = new G4VisExecutive("Quiet");
+  startupTimer->Start("VisExecutive");
   visManager->Initialize();
+  startupTimer->Stop("VisExecutive");
 
 
   // Get the pointer to the User Interface manager
   auto UImanager = G4UImanager::GetUIpointer();
 
+  // Run options which are forwarded to the user actions (master and workers)
+  for ( const auto& command : options.GetCommands() ) {
+    UImanager->ApplyCommand(command);
+  }
+
   if ( !ui ) {
     // execute an argument macro file if exist
-    G4String command = "/control/execute ";
-    G4String fileName = argv[1];
-    UImanager->ApplyCommand(command+fileName);
+    if ( !options.GetMacro().empty() ) {
+      G4String command = "/control/execute ";
+      startupTimer->Start("Macro");
+      UImanager->ApplyCommand(command+options.GetMacro());
+      startupTimer->Stop("Macro");
+    }
+    // and the requested number of events
+    if ( options.GetEvents() > 0 ) {
+      auto state = G4StateManager::GetStateManager()->GetCurrentState();
+      if ( state == G4State_PreInit ) {
+        UImanager->ApplyCommand("/run/initialize");
+      }
+      UImanager->ApplyCommand("/run/beamOn "
+                              + G4UIcommand::ConvertToString(options.GetEvents()));
+    }
   }
   else {
     UImanager->ApplyCommand("/control/execute init_vis.mac");
@@ -107,6 +158,12 @@ int main(int argc,char** argv)
   // owned and deleted by the run manager, so they should not be deleted 
   // in the main() program !
 
+  // Startup phase timing report (all threads have initialized by now)
+  if ( !options.GetStartupReport().empty() 
+       && !startupTimer->Write(options.GetStartupReport()) ) {
+    G4cerr << "proton_pol: cannot write " << options.GetStartupReport() << G4endl;
+  }
+
   delete visManager;
   delete runManager;
 }
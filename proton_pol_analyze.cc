@@ -0,0 +1,362 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file proton_pol_analyze.cc
+/// \brief Parallel polarimetry analyzer of the native columnar event files
+///
+/// execute-proton_pol_analyze [-j threads] [-P polarization] 
+///                            [-b nbins theta_min theta_max] [-w theta_low theta_high]
+///                            [-N incident events] [-o asymmetry.csv] [-H histos.txt]
+///                            [-A analyzing_power_table [-S px,py] -p px,py ...]
+///                            input.ppcol...
+///
+/// Re-analyzes the event output of proton_pol (/proton_pol/output/columnarFile)
+/// on all cores (-j, default all hardware threads): the theta binning of the
+/// asymmetry (-b, default 20 bins from 5 to 25 deg, as /proton_pol/asymmetry/),
+/// the theta window of the analysis histograms (-w, default 10 to 20 deg,
+/// as EventAction) and the beam polarization (-P, default 1) can be changed
+/// without a new simulation. It prints the asymmetry table of the run
+/// summary and writes with -o the asymmetry per theta bin and with -H the
+/// analysis_theta, analysis_phi, analysis_cosphi and analysis_sinphi
+/// histograms. The efficiencies are given per written event, or per -N
+/// incident events when the event skim was on.
+///
+/// With -A and -p the sample is reweighted, in the same pass, to every
+/// beam polarization vector -p (repeated) : an event scattered to the
+/// azimuth phi, with the normal n = (-sin(phi), cos(phi), 0) to the
+/// scattering plane, gets the weight
+///   w (1 + A_y(theta, T) P.n) / (1 + A_y(theta, T) P_sim.n)
+/// with the analyzing power table (AnalyzingPowerTable, T : kinetic energy
+/// of the DCOUT proton) and the simulated polarization -S (default 0,0: the
+/// physics of the simulation does not depend on the beam polarization, the
+/// spin of PrimaryGeneratorAction is not used). The results of polarization i are printed
+/// and written to the -o and -H files with the suffix _pol<i>, the
+/// analyzing power is given for P_y (or for P_y = 1 when P_y is 0).
+/// Longitudinal components of P do not change the weights.
+///
+/// The program does not depend on Geant4.
+
+#include "AnalyzingPowerTable.hh"
+#include "AsymmetryAccumulator.hh"
+#include "ColumnarScan.hh"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// fixed binning histogram with the errors of the weights
+struct Histogram {
+  std::string name;
+  int nbins;
+  double xmin, xmax;
+  double entries;
+  std::vector<double> sum_w, sum_w2;
+
+  Histogram(const std::string& a_name, int a_nbins, double a_xmin, double a_xmax)
+  : name(a_name), nbins(a_nbins), xmin(a_xmin), xmax(a_xmax), entries(0.),
+    sum_w(a_nbins, 0.), sum_w2(a_nbins, 0.) {}
+
+  void Fill(double x, double weight) {
+    entries += 1.;
+    if (x < xmin || x >= xmax) return;
+    auto i_bin = (int)((x - xmin)/(xmax - xmin)*nbins);
+    if (i_bin >= nbins) i_bin = nbins - 1;
+    sum_w[i_bin] += weight;
+    sum_w2[i_bin] += weight*weight;
+  }
+
+  void Add(const Histogram& other) {
+    entries += other.entries;
+    for (auto i_bin = 0; i_bin < nbins; ++i_bin) {
+      sum_w[i_bin] += other.sum_w[i_bin];
+      sum_w2[i_bin] += other.sum_w2[i_bin];
+    }
+  }
+};
+
+// analysis histograms of EventAction
+std::vector<Histogram> AnalysisHistograms()
+{
+  return { Histogram("analysis_theta", 180, 0., 180.),
+           Histogram("analysis_phi", 360, -180., 180.),
+           Histogram("analysis_cosphi", 200, -1., 1.),
+           Histogram("analysis_sinphi", 200, -1., 1.) };
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool WriteHistograms(const std::string& path, const std::vector<Histogram>& histograms,
+                     std::size_t events)
+{
+  std::ofstream output(path);
+  if (!output) return false;
+
+  // same layout as the H1 of the snapshots (Snapshot)
+  output << "# proton_pol analyze : " << events << " events\n"
+         << "# h1 name nbins xmin xmax entries, then per bin : lower edge, height, error\n"
+         << std::setprecision(8);
+  for (const auto& histogram : histograms) {
+    output << "h1 " << histogram.name << " " << histogram.nbins << " " 
+           << histogram.xmin << " " << histogram.xmax << " " << histogram.entries << "\n";
+    auto width = (histogram.xmax - histogram.xmin)/histogram.nbins;
+    for (auto i_bin = 0; i_bin < histogram.nbins; ++i_bin) {
+      output << histogram.xmin + i_bin*width << " " << histogram.sum_w[i_bin] << " " 
+             << std::sqrt(histogram.sum_w2[i_bin]) << "\n";
+    }
+  }
+  return (bool)output;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// beam polarization vector px,py[,pz]
+struct Polarization {
+  double x, y, z;
+};
+
+bool ParsePolarization(const std::string& text, Polarization& polarization)
+{
+  polarization = { 0., 0., 0. };
+  return std::sscanf(text.c_str(), "%lf,%lf,%lf", 
+                     &polarization.x, &polarization.y, &polarization.z) >= 2;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// path with _pol<i> before the extension
+std::string Suffixed(const std::string& path, std::size_t i_polarization)
+{
+  auto suffix = "_pol" + std::to_string(i_polarization);
+  auto dot = path.rfind('.');
+  auto slash = path.rfind('/');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+    return path + suffix;
+  }
+  return path.substr(0, dot) + suffix + path.substr(dot);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrintUsage()
+{
+  std::cerr << "Usage: execute-proton_pol_analyze [-j threads] [-P polarization]\n"
+            << "         [-b nbins theta_min theta_max] [-w theta_low theta_high]\n"
+            << "         [-N incident events] [-o asymmetry.csv] [-H histos.txt]\n"
+            << "         [-A analyzing_power_table [-S px,py] -p px,py ...]\n"
+            << "         input.ppcol..." << std::endl;
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv)
+{
+  int threads = 0;
+  double polarization = 1.;
+  int nbins = 20;
+  double theta_min = 5., theta_max = 25.;
+  double window_low = 10., window_high = 20.;
+  double incident_events = 0.;
+  std::string csv, histos, table_file;
+  Polarization simulated = { 0., 0., 0. };
+  std::vector<Polarization> polarizations;
+  std::vector<std::string> inputs;
+  for (auto i_arg = 1; i_arg < argc; ++i_arg) {
+    std::string arg = argv[i_arg];
+    if (arg == "-j" && i_arg+1 < argc) threads = std::atoi(argv[++i_arg]);
+    else if (arg == "-P" && i_arg+1 < argc) polarization = std::atof(argv[++i_arg]);
+    else if (arg == "-b" && i_arg+3 < argc) {
+      nbins = std::atoi(argv[++i_arg]);
+      theta_min = std::atof(argv[++i_arg]);
+      theta_max = std::atof(argv[++i_arg]);
+    }
+    else if (arg == "-w" && i_arg+2 < argc) {
+      window_low = std::atof(argv[++i_arg]);
+      window_high = std::atof(argv[++i_arg]);
+    }
+    else if (arg == "-N" && i_arg+1 < argc) incident_events = std::atof(argv[++i_arg]);
+    else if (arg == "-o" && i_arg+1 < argc) csv = argv[++i_arg];
+    else if (arg == "-H" && i_arg+1 < argc) histos = argv[++i_arg];
+    else if (arg == "-A" && i_arg+1 < argc) table_file = argv[++i_arg];
+    else if (arg == "-S" && i_arg+1 < argc) {
+      if (!ParsePolarization(argv[++i_arg], simulated)) {
+        PrintUsage();
+        return 1;
+      }
+    }
+    else if (arg == "-p" && i_arg+1 < argc) {
+      Polarization target;
+      if (!ParsePolarization(argv[++i_arg], target)) {
+        PrintUsage();
+        return 1;
+      }
+      polarizations.push_back(target);
+    }
+    else if (arg[0] == '-') {
+      PrintUsage();
+      return 1;
+    }
+    else inputs.push_back(arg);
+  }
+  auto reweighting = !polarizations.empty();
+  if (inputs.empty() || reweighting == table_file.empty()) {
+    PrintUsage();
+    return 1;
+  }
+
+  AnalyzingPowerTable table;
+  if (reweighting && !table.Read(table_file)) {
+    std::cerr << "proton_pol_analyze: cannot read the analyzing power table " 
+              << table_file << std::endl;
+    return 1;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  // every thread fills its own accumulator and histograms per polarization
+  ColumnarScan scan(inputs, threads);
+  std::size_t nvariants = reweighting ? polarizations.size() : 1;
+  std::size_t nslots = scan.GetNumberOfThreads()*nvariants;
+  std::vector<AsymmetryAccumulator> asymmetries(nslots, 
+    AsymmetryAccumulator(nbins, theta_min, theta_max));
+  std::vector<std::vector<Histogram>> histograms(nslots, AnalysisHistograms());
+  struct Buffers {
+    std::vector<double> phi, analyzing_power, base_weight, weight;
+  };
+  std::vector<Buffers> buffers(scan.GetNumberOfThreads());
+
+  auto ok = scan.Run([&](int thread, const ScatteringBatch& batch) {
+    auto& buffer = buffers[thread];
+    auto n = batch.size;
+    buffer.phi.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      buffer.phi[i] = std::atan2(batch.sin_phi[i], batch.cos_phi[i])*(180./M_PI);
+    }
+
+    // weight without the simulated polarization, P.n = P_y cos(phi) - P_x sin(phi)
+    if (reweighting) {
+      buffer.analyzing_power.resize(n);
+      buffer.base_weight.resize(n);
+      buffer.weight.resize(n);
+      for (std::size_t i = 0; i < n; ++i) {
+        auto analyzing_power = table.GetValue(batch.theta[i], batch.energy[i]);
+        buffer.analyzing_power[i] = analyzing_power;
+        buffer.base_weight[i] = batch.weight[i]
+          /(1. + analyzing_power*(simulated.y*batch.cos_phi[i] - simulated.x*batch.sin_phi[i]));
+      }
+    }
+
+    for (std::size_t i_variant = 0; i_variant < nvariants; ++i_variant) {
+      const double* weights = batch.weight;
+      if (reweighting) {
+        const auto& target = polarizations[i_variant];
+        const double* __restrict__ analyzing_power = buffer.analyzing_power.data();
+        const double* __restrict__ base_weight = buffer.base_weight.data();
+        double* __restrict__ weight = buffer.weight.data();
+        for (std::size_t i = 0; i < n; ++i) {
+          weight[i] = base_weight[i]
+            *(1. + analyzing_power[i]*(target.y*batch.cos_phi[i] - target.x*batch.sin_phi[i]));
+        }
+        weights = weight;
+      }
+
+      auto& asymmetry = asymmetries[thread*nvariants + i_variant];
+      auto& h1 = histograms[thread*nvariants + i_variant];
+      asymmetry.AddEvent(batch.events);
+      for (std::size_t i = 0; i < n; ++i) {
+        auto theta = batch.theta[i];
+        auto weight = weights[i];
+        asymmetry.FillDirection(theta, batch.cos_phi[i], batch.sin_phi[i], weight);
+        if (window_low < theta && theta < window_high) {
+          h1[0].Fill(theta, weight);
+          h1[1].Fill(buffer.phi[i], weight);
+          h1[2].Fill(batch.cos_phi[i], weight);
+          h1[3].Fill(batch.sin_phi[i], weight);
+        }
+      }
+    }
+  });
+  if (!ok) {
+    std::cerr << "proton_pol_analyze: " << scan.GetError() << std::endl;
+    return 1;
+  }
+
+  // merge the threads
+  for (std::size_t i_variant = 0; i_variant < nvariants; ++i_variant) {
+    for (auto i_thread = 1; i_thread < scan.GetNumberOfThreads(); ++i_thread) {
+      auto i_slot = i_thread*nvariants + i_variant;
+      asymmetries[i_variant].Merge(asymmetries[i_slot]);
+      for (std::size_t i_h1 = 0; i_h1 < histograms[i_variant].size(); ++i_h1) {
+        histograms[i_variant][i_h1].Add(histograms[i_slot][i_h1]);
+      }
+    }
+    auto& asymmetry = asymmetries[i_variant];
+    if (incident_events > 0.) asymmetry.AddEvent(incident_events - asymmetry.GetEvents());
+  }
+
+  std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+  std::cout << "proton_pol_analyze: " << scan.GetNumberOfRows() << " events of " 
+            << inputs.size() << " files in " << time.count() << " s with " 
+            << scan.GetNumberOfThreads() << " threads (" 
+            << scan.GetNumberOfRows()/time.count() << " events/s)" << std::endl;
+
+  for (std::size_t i_variant = 0; i_variant < nvariants; ++i_variant) {
+    auto variant_csv = csv, variant_histos = histos;
+    auto variant_polarization = polarization;
+    if (reweighting) {
+      const auto& target = polarizations[i_variant];
+      std::cout << "--- polarization " << i_variant << " : (" << target.x << ", " 
+                << target.y << ", " << target.z << ")" << std::endl;
+      if (!csv.empty()) variant_csv = Suffixed(csv, i_variant);
+      if (!histos.empty()) variant_histos = Suffixed(histos, i_variant);
+      variant_polarization = target.y != 0. ? target.y : 1.;
+    }
+
+    const auto& asymmetry = asymmetries[i_variant];
+    asymmetry.Print(std::cout, variant_polarization, window_low, window_high);
+    if (!variant_csv.empty() && !asymmetry.Write(variant_csv, variant_polarization)) {
+      std::cerr << "proton_pol_analyze: cannot write " << variant_csv << std::endl;
+      return 1;
+    }
+    if (!variant_histos.empty() 
+        && !WriteHistograms(variant_histos, histograms[i_variant], scan.GetNumberOfRows())) {
+      std::cerr << "proton_pol_analyze: cannot write " << variant_histos << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,150 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file proton_pol_batch.cc
+/// \brief Headless batch program of proton_pol (no UI session, no visualization)
+
+#include "DetectorConstruction.hh"
+#include "ActionInitialization.hh"
+#include "PhysicsList.hh"
+#include "CommandLineOptions.hh"
+#include "ThreadScalingBenchmark.hh"
+#include "ForkedJob.hh"
+#include "Checkpoint.hh"
+#include "StartupTimer.hh"
+
+#include "G4RunManagerFactory.hh"
+#include "G4StateManager.hh"
+#include "G4UImanager.hh"
+#include "G4UIcommand.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc,char** argv)
+{
+  // Parse the command line
+  //
+  CommandLineOptions options;
+  if ( !options.Parse(argc, argv) || options.GetHelp() ) {
+    options.PrintUsage(argv[0]);
+    return options.GetHelp() ? 0 : 1;
+  }
+
+  // Thread-scaling benchmark : runs this executable once per thread count
+  //
+  if ( options.GetScalingThreads() > 0 ) {
+    ThreadScalingBenchmark benchmark(argv[0], options);
+    return benchmark.Execute();
+  }
+
+  // There is no interactive session : a macro or events are required
+  //
+  if ( options.IsInteractive() ) {
+    G4cerr << "proton_pol_batch: nothing to do, give a macro or --events" << G4endl;
+    options.PrintUsage(argv[0]);
+    return 1;
+  }
+
+  // Time the startup phases of the master thread
+  //
+  auto startupTimer = StartupTimer::Instance();
+  startupTimer->ObserveStates();
+
+  // Construct the run manager (serial, MT or task based)
+  //
+  startupTimer->Start("RunManager");
+  auto runManager 
+    = G4RunManagerFactory::CreateRunManager(options.GetRunManagerType());
+  startupTimer->Stop("RunManager");
+  if ( options.GetThreads() > 0 ) {
+    runManager->SetNumberOfThreads(options.GetThreads());
+  }
+
+  // Mandatory user initialization classes
+  startupTimer->Start("UserInitialization");
+  runManager->SetUserInitialization(new DetectorConstruction);
+
+  auto physicslist = new PhysicsList();
+  physicslist->AddPhysicsList(options.GetPhysicsList());
+  runManager->SetUserInitialization(physicslist);
+
+  // User action initialization
+  runManager->SetUserInitialization(new ActionInitialization());
+  startupTimer->Stop("UserInitialization");
+
+  // Run options which are forwarded to the user actions (master and workers)
+  auto UImanager = G4UImanager::GetUIpointer();
+  for ( const auto& command : options.GetCommands() ) {
+    UImanager->ApplyCommand(command);
+  }
+
+  // Execute the macro, then the requested number of events
+  G4int status = 0;
+  if ( !options.GetMacro().empty() ) {
+    startupTimer->Start("Macro");
+    status = UImanager->ApplyCommand("/control/execute " + options.GetMacro());
+    startupTimer->Stop("Macro");
+  }
+  if ( status == 0 && !options.GetCheckpoint().empty()
+       && (options.GetEvents() > 0 || options.GetResume()) ) {
+    // chain of runs with a checkpoint after each
+    Checkpoint checkpoint(options);
+    status = checkpoint.Execute();
+  }
+  else if ( status == 0 && options.GetEvents() > 0 && options.GetProcesses() > 0 ) {
+    // initialization once, then the events in forked processes
+    ForkedJob job(argv[0], options);
+    status = job.Execute();
+  }
+  else if ( status == 0 && options.GetEvents() > 0 ) {
+    auto state = G4StateManager::GetStateManager()->GetCurrentState();
+    if ( state == G4State_PreInit ) {
+      status = UImanager->ApplyCommand("/run/initialize");
+    }
+    if ( status == 0 ) {
+      status = UImanager->ApplyCommand("/run/beamOn "
+                 + G4UIcommand::ConvertToString(options.GetEvents()));
+    }
+  }
+  if ( status != 0 ) {
+    G4cerr << "proton_pol_batch: command failed with status " << status << G4endl;
+  }
+
+  // Startup phase timing report
+  if ( !options.GetStartupReport().empty() 
+       && !startupTimer->Write(options.GetStartupReport()) ) {
+    G4cerr << "proton_pol_batch: cannot write " << options.GetStartupReport() << G4endl;
+  }
+
+  // Job termination
+  // user actions, physics_list and detector_description are owned and 
+  // deleted by the run manager
+  delete runManager;
+
+  return status == 0 ? 0 : 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
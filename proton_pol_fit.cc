@@ -0,0 +1,212 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file proton_pol_fit.cc
+/// \brief Unbinned maximum-likelihood polarization fit of the columnar event files
+///
+/// execute-proton_pol_fit [-j threads] [-w theta_low theta_high] [-s]
+///                        -A analyzing_power_table   input.ppcol...
+/// execute-proton_pol_fit [-j threads] [-w theta_low theta_high] [-s]
+///                        [-P polarization] [-d degree] [-o table]   input.ppcol...
+///
+/// Fits the azimuthal distribution of the scattered protons of the theta
+/// window (-w, default 10 to 20 deg, as EventAction), event by event with
+/// their weights (UnbinnedFit):
+/// - with -A, the beam polarization P of
+///     f(phi | theta) ~ 1 + P A_y(theta) cos(phi) + b sin(phi)
+///   with the tabulated analyzing power (AnalyzingPowerTable : asymmetry
+///   CSV file of a calibration run, "theta A_y" or "theta T A_y" lines,
+///   T : kinetic energy of the DCOUT proton)
+/// - otherwise, the analyzing power of a calibration sample with the known
+///   polarization -P (default 1) as a polynomial of degree -d (default 2)
+///   in t = (theta - theta_centre)/(half width of the window)
+///     f(phi | theta) ~ 1 + P sum_k c_k t^k cos(phi) + b sin(phi)
+///   written with -o as a "theta A_y" table for -A.
+/// The sin(phi) term b (false asymmetry) is left out with -s.
+///
+/// The program does not depend on Geant4.
+
+#include "AnalyzingPowerTable.hh"
+#include "ColumnarScan.hh"
+#include "UnbinnedFit.hh"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void PrintUsage()
+{
+  std::cerr << "Usage: execute-proton_pol_fit [-j threads] [-w theta_low theta_high] [-s]\n"
+            << "         -A analyzing_power_table input.ppcol...\n"
+            << "       execute-proton_pol_fit [-j threads] [-w theta_low theta_high] [-s]\n"
+            << "         [-P polarization] [-d degree] [-o table] input.ppcol..." 
+            << std::endl;
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv)
+{
+  int threads = 0;
+  double window_low = 10., window_high = 20.;
+  bool sin_term = true;
+  std::string table_file, output;
+  double polarization = 1.;
+  int degree = 2;
+  std::vector<std::string> inputs;
+  for (auto i_arg = 1; i_arg < argc; ++i_arg) {
+    std::string arg = argv[i_arg];
+    if (arg == "-j" && i_arg+1 < argc) threads = std::atoi(argv[++i_arg]);
+    else if (arg == "-w" && i_arg+2 < argc) {
+      window_low = std::atof(argv[++i_arg]);
+      window_high = std::atof(argv[++i_arg]);
+    }
+    else if (arg == "-s") sin_term = false;
+    else if (arg == "-A" && i_arg+1 < argc) table_file = argv[++i_arg];
+    else if (arg == "-P" && i_arg+1 < argc) polarization = std::atof(argv[++i_arg]);
+    else if (arg == "-d" && i_arg+1 < argc) degree = std::atoi(argv[++i_arg]);
+    else if (arg == "-o" && i_arg+1 < argc) output = argv[++i_arg];
+    else if (arg[0] == '-') {
+      PrintUsage();
+      return 1;
+    }
+    else inputs.push_back(arg);
+  }
+  auto calibration = table_file.empty();
+  if (inputs.empty() || !(window_low < window_high) 
+      || (calibration && (degree < 0 || degree + 2 > (int)UnbinnedFit::kMaxParameters))) {
+    PrintUsage();
+    return 1;
+  }
+
+  AnalyzingPowerTable table;
+  if (!calibration && !table.Read(table_file)) {
+    std::cerr << "proton_pol_fit: cannot read the analyzing power table " 
+              << table_file << std::endl;
+    return 1;
+  }
+
+  // parameters
+  std::vector<std::string> names;
+  if (calibration) {
+    for (auto k = 0; k <= degree; ++k) names.push_back("c" + std::to_string(k));
+  }
+  else {
+    names.push_back("P");
+  }
+  if (sin_term) names.push_back("b_sin");
+
+  auto start = std::chrono::steady_clock::now();
+
+  // features of the events of the window, one partition per scan thread
+  ColumnarScan scan(inputs, threads);
+  UnbinnedFit fit(names, scan.GetNumberOfThreads());
+  auto centre = 0.5*(window_low + window_high);
+  auto half_width = 0.5*(window_high - window_low);
+  auto ok = scan.Run([&](int thread, const ScatteringBatch& batch) {
+    double features[UnbinnedFit::kMaxParameters];
+    for (std::size_t i = 0; i < batch.size; ++i) {
+      auto theta = batch.theta[i];
+      if (!(window_low < theta && theta < window_high)) continue;
+      std::size_t n = 0;
+      if (calibration) {
+        auto t = (theta - centre)/half_width;
+        auto power = polarization*batch.cos_phi[i];
+        for (auto k = 0; k <= degree; ++k, power *= t) features[n++] = power;
+      }
+      else {
+        features[n++] = table.GetValue(theta, batch.energy[i])*batch.cos_phi[i];
+      }
+      if (sin_term) features[n++] = batch.sin_phi[i];
+      fit.AddEvent(thread, features, batch.weight[i]);
+    }
+  });
+  if (!ok) {
+    std::cerr << "proton_pol_fit: " << scan.GetError() << std::endl;
+    return 1;
+  }
+  std::chrono::duration<double> read_time = std::chrono::steady_clock::now() - start;
+
+  ok = fit.Minimize();
+  std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+  std::cout << "proton_pol_fit: " << fit.GetNumberOfEvents() << " events in " 
+            << window_low << " < theta < " << window_high << " deg (sum of weights " 
+            << fit.GetSumOfWeights() << ") of " << scan.GetNumberOfRows() 
+            << ", read in " << read_time.count() << " s, fitted in " 
+            << time.count() - read_time.count() << " s (" << fit.GetIterations() 
+            << " iterations, " << scan.GetNumberOfThreads() << " threads)" << std::endl;
+  if (!ok) {
+    std::cerr << "proton_pol_fit: " << fit.GetError() << std::endl;
+    return 1;
+  }
+
+  std::printf(" -ln L = %.6f\n", fit.GetMinimum());
+  for (std::size_t i = 0; i < fit.GetNumberOfParameters(); ++i) {
+    std::printf(" %-8s = %12.6f +- %10.6f\n", 
+                fit.GetName(i).c_str(), fit.GetParameter(i), fit.GetParameterError(i));
+  }
+  if (fit.GetNumberOfParameters() > 1) {
+    std::printf(" correlations :\n");
+    for (std::size_t i = 0; i < fit.GetNumberOfParameters(); ++i) {
+      std::printf(" %-8s", fit.GetName(i).c_str());
+      for (std::size_t j = 0; j < fit.GetNumberOfParameters(); ++j) {
+        std::printf(" %7.3f", fit.GetCovariance(i, j)
+                    /(fit.GetParameterError(i)*fit.GetParameterError(j)));
+      }
+      std::printf("\n");
+    }
+  }
+
+  // fitted analyzing power as a table for -A
+  if (calibration && !output.empty()) {
+    std::ofstream table_output(output);
+    table_output << "# analyzing power fitted by proton_pol_fit, polarization " 
+                 << polarization << "\n# theta A_y\n";
+    for (auto i_point = 0; i_point <= 40; ++i_point) {
+      auto theta = window_low + i_point*(window_high - window_low)/40.;
+      auto t = (theta - centre)/half_width;
+      auto value = 0., power = 1.;
+      for (auto k = 0; k <= degree; ++k, power *= t) value += fit.GetParameter(k)*power;
+      table_output << theta << " " << value << "\n";
+    }
+    if (!table_output) {
+      std::cerr << "proton_pol_fit: cannot write " << output << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
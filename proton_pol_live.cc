@@ -0,0 +1,158 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file proton_pol_live.cc
+/// \brief Terminal viewer of the live histograms of a running proton_pol job
+///
+/// execute-proton_pol_live [-i interval] [-n count] [segment]
+///
+/// Maps the shared memory segment (default /proton_pol_live, see
+/// /proton_pol/live/) and prints every interval seconds (default 1) the
+/// entries, mean and rms of the published histograms, count times
+/// (default 0 : until interrupted). The job is never blocked.
+///
+/// The program does not depend on Geant4.
+
+#include "LiveHistogramReader.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+void PrintUsage()
+{
+  std::cerr << "Usage: execute-proton_pol_live [-i interval] [-n count] [segment]" 
+            << std::endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// mean and rms of the bin centers along x (axis 0) or y (axis 1)
+void Moments(const LiveHistogramInfo& info, const double* bins, int axis,
+             double& mean, double& rms)
+{
+  double sum = 0., sum_x = 0., sum_x2 = 0.;
+  auto width_x = (info.xmax - info.xmin)/info.nx;
+  auto width_y = info.dimension == 2 ? (info.ymax - info.ymin)/info.ny : 0.;
+  for (std::uint32_t i_x = 0; i_x < info.nx; ++i_x) {
+    for (std::uint32_t i_y = 0; i_y < info.ny; ++i_y) {
+      auto height = bins[i_x*info.ny + i_y];
+      auto x = axis == 0 ? info.xmin + (i_x + 0.5)*width_x 
+                         : info.ymin + (i_y + 0.5)*width_y;
+      sum += height;
+      sum_x += height*x;
+      sum_x2 += height*x*x;
+    }
+  }
+  mean = sum > 0. ? sum_x/sum : 0.;
+  rms = sum > 0. ? std::sqrt(std::max(0., sum_x2/sum - mean*mean)) : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Print(const LiveHistogramReader& reader)
+{
+  std::printf("\n=== %s : %llu events (generation %llu)\n",
+              "proton_pol live histograms",
+              (unsigned long long)reader.GetEvents(), 
+              (unsigned long long)reader.GetGeneration());
+  std::printf(" %-28s %12s %12s %12s %12s %12s\n", 
+              "histogram", "entries", "mean x", "rms x", "mean y", "rms y");
+  for (std::size_t i_histogram = 0; i_histogram < reader.GetNumberOfHistograms(); ++i_histogram) {
+    const auto& info = reader.GetInfo(i_histogram);
+    const auto bins = reader.GetBins(i_histogram);
+    double mean_x, rms_x;
+    Moments(info, bins, 0, mean_x, rms_x);
+    std::printf(" %-28s %12.0f %12.5g %12.5g", 
+                info.name, reader.GetEntries(i_histogram), mean_x, rms_x);
+    if (info.dimension == 2) {
+      double mean_y, rms_y;
+      Moments(info, bins, 1, mean_y, rms_y);
+      std::printf(" %12.5g %12.5g", mean_y, rms_y);
+    }
+    std::printf("\n");
+  }
+  std::fflush(stdout);
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv)
+{
+  double interval = 1.;
+  long count = 0;
+  std::string segment = "/proton_pol_live";
+  for (auto i_arg = 1; i_arg < argc; ++i_arg) {
+    std::string arg = argv[i_arg];
+    if (arg == "-i" && i_arg + 1 < argc) {
+      interval = std::atof(argv[++i_arg]);
+    }
+    else if (arg == "-n" && i_arg + 1 < argc) {
+      count = std::atol(argv[++i_arg]);
+    }
+    else if (arg[0] == '-') {
+      PrintUsage();
+      return 1;
+    }
+    else {
+      segment = arg;
+    }
+  }
+  if (interval <= 0.) {
+    PrintUsage();
+    return 1;
+  }
+
+  LiveHistogramReader reader;
+  bool waiting = false;
+  for (long i_print = 0; count == 0 || i_print < count; ) {
+    // a new job, or a new segment of the job, is mapped again
+    if (!reader.IsOpen() || !reader.Read()) {
+      if (!reader.Open(segment) || !reader.Read()) {
+        if (!waiting) std::cerr << "Waiting for the segment " << segment << std::endl;
+        waiting = true;
+        std::this_thread::sleep_for(std::chrono::duration<double>(interval));
+        continue;
+      }
+    }
+    waiting = false;
+    Print(reader);
+    ++i_print;
+    std::this_thread::sleep_for(std::chrono::duration<double>(interval));
+  }
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,218 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file proton_pol_merge.cc
+/// \brief Merge tool of the outputs of several proton_pol processes
+///
+/// execute-proton_pol_merge [-P polarization] [-z] output input...
+///
+/// The type of merge follows the extension of the output file:
+/// - .state : raw sums of the asymmetry accumulators (AsymmetryAccumulator)
+/// - .csv   : asymmetry results of the merged raw sums (inputs .state)
+/// - .ppcol : rows of native columnar files with the same columns, 
+///            zlib block compression with -z
+/// - .root  : histograms and ntuples, with hadd of ROOT (if set up; the
+///            forked jobs of proton_pol_batch merge their histograms
+///            themselves)
+///
+/// The program does not depend on Geant4.
+
+#include "AsymmetryAccumulator.hh"
+#include "ColumnarReader.hh"
+#include "ColumnarWriter.hh"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool EndsWith(const std::string& name, const std::string& extension)
+{
+  return name.size() >= extension.size()
+      && name.compare(name.size()-extension.size(), extension.size(), extension) == 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool MergeAsymmetry(const std::string& output, const std::vector<std::string>& inputs,
+                    double polarization)
+{
+  AsymmetryAccumulator merged;
+  for (std::size_t i_input = 0; i_input < inputs.size(); ++i_input) {
+    AsymmetryAccumulator accumulator;
+    if (!accumulator.Load(inputs[i_input])) {
+      std::cerr << "proton_pol_merge: cannot read " << inputs[i_input] << std::endl;
+      return false;
+    }
+    if (i_input == 0) {
+      merged.SetBinning(accumulator.GetNbins(), 
+                        accumulator.GetThetaMin(), accumulator.GetThetaMax());
+    }
+    else if (accumulator.GetNbins() != merged.GetNbins()
+             || accumulator.GetThetaMin() != merged.GetThetaMin()
+             || accumulator.GetThetaMax() != merged.GetThetaMax()) {
+      std::cerr << "proton_pol_merge: other theta binning in " 
+                << inputs[i_input] << std::endl;
+      return false;
+    }
+    merged.Merge(accumulator);
+  }
+
+  return EndsWith(output, ".csv") ? merged.Write(output, polarization) 
+                                  : merged.Save(output);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool MergeColumnar(const std::string& output, const std::vector<std::string>& inputs,
+                   bool compress)
+{
+  ColumnarWriter writer;
+  ColumnarReader reader;
+  std::vector<std::string> names;
+  std::vector<ColumnarType> types;
+  for (std::size_t i_input = 0; i_input < inputs.size(); ++i_input) {
+    if (!reader.Open(inputs[i_input])) {
+      std::cerr << "proton_pol_merge: cannot read " << inputs[i_input] << std::endl;
+      return false;
+    }
+
+    // the columns of the first file define the output
+    auto ncolumns = reader.GetNumberOfColumns();
+    if (i_input == 0) {
+      for (std::size_t i_column = 0; i_column < ncolumns; ++i_column) {
+        names.push_back(reader.GetColumnName(i_column));
+        types.push_back(reader.GetColumnType(i_column));
+        writer.AddColumn(names.back(), types.back());
+      }
+      if (!writer.Open(output, compress ? kCodecZlib : kCodecNone, 65536)) {
+        std::cerr << "proton_pol_merge: cannot write " << output << std::endl;
+        return false;
+      }
+    }
+    auto same = (ncolumns == names.size());
+    for (std::size_t i_column = 0; same && i_column < ncolumns; ++i_column) {
+      same = reader.GetColumnName(i_column) == names[i_column]
+          && reader.GetColumnType(i_column) == types[i_column];
+    }
+    if (!same) {
+      std::cerr << "proton_pol_merge: other columns in " << inputs[i_input] << std::endl;
+      return false;
+    }
+
+    // rows, block by block
+    std::vector<const void*> data(ncolumns);
+    for (std::size_t i_block = 0; i_block < reader.GetNumberOfBlocks(); ++i_block) {
+      for (std::size_t i_column = 0; i_column < ncolumns; ++i_column) {
+        data[i_column] = reader.GetBlockData(i_block, i_column);
+        if (!data[i_column]) {
+          std::cerr << "proton_pol_merge: corrupted block in " 
+                    << inputs[i_input] << std::endl;
+          return false;
+        }
+      }
+      for (std::size_t i_row = 0; i_row < reader.GetBlockRows(i_block); ++i_row) {
+        for (std::size_t i_column = 0; i_column < ncolumns; ++i_column) {
+          switch (reader.GetColumnType(i_column)) {
+            case kColumnInt32:
+              writer.Fill(i_column, static_cast<const std::int32_t*>(data[i_column])[i_row]);
+              break;
+            case kColumnFloat32:
+              writer.Fill(i_column, static_cast<const float*>(data[i_column])[i_row]);
+              break;
+            case kColumnFloat64:
+              writer.Fill(i_column, static_cast<const double*>(data[i_column])[i_row]);
+              break;
+          }
+        }
+        writer.AddRow();
+      }
+    }
+    reader.Close();
+  }
+  return writer.Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool MergeRoot(const std::string& output, const std::vector<std::string>& inputs)
+{
+  std::string command = "hadd -f \"" + output + "\"";
+  for (const auto& input : inputs) command += " \"" + input + "\"";
+  if (std::system(command.c_str()) != 0) {
+    std::cerr << "proton_pol_merge: hadd failed (is ROOT set up?)" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc,char** argv)
+{
+  double polarization = 1.;
+  bool compress = false;
+  std::vector<std::string> files;
+  for (auto i_arg = 1; i_arg < argc; ++i_arg) {
+    std::string arg = argv[i_arg];
+    if (arg == "-P" && i_arg+1 < argc) polarization = std::atof(argv[++i_arg]);
+    else if (arg == "-z") compress = true;
+    else files.push_back(arg);
+  }
+  if (files.size() < 2) {
+    std::cerr << "Usage: " << argv[0] 
+              << " [-P polarization] [-z] output input..." << std::endl;
+    return 1;
+  }
+
+  auto output = files[0];
+  std::vector<std::string> inputs(files.begin()+1, files.end());
+
+  auto ok = false;
+  if (EndsWith(output, ".state") || EndsWith(output, ".csv")) {
+    ok = MergeAsymmetry(output, inputs, polarization);
+  }
+  else if (EndsWith(output, ".ppcol")) {
+    ok = MergeColumnar(output, inputs, compress);
+  }
+  else if (EndsWith(output, ".root")) {
+    ok = MergeRoot(output, inputs);
+  }
+  else {
+    std::cerr << "proton_pol_merge: unknown output type " << output << std::endl;
+  }
+  if (!ok) return 1;
+
+  std::cout << "proton_pol_merge: " << inputs.size() << " files merged into " 
+            << output << std::endl;
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,242 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file proton_pol_microbench.cc
+/// \brief Micro-benchmarks of the user hot paths of proton_pol
+///
+/// Drives DriftChamberSD::ProcessHits, EventAction::EndOfEventAction and
+/// PrimaryGeneratorAction::GeneratePrimaries with synthetic steps, hit
+/// stores and events inside an open run (serial run manager, EM physics
+/// only) and reports ns/call and heap allocations/call.
+///
+/// execute-proton_pol_microbench [calls] [hits per event]
+
+#include "DetectorConstruction.hh"
+#include "ActionInitialization.hh"
+#include "PhysicsList.hh"
+#include "DriftChamberSD.hh"
+
+#include "G4RunManagerFactory.hh"
+#include "G4UImanager.hh"
+#include "G4SDManager.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4Event.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4DynamicParticle.hh"
+#include "G4Proton.hh"
+#include "G4Electron.hh"
+#include "G4UserEventAction.hh"
+#include "G4VUserPrimaryGeneratorAction.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <vector>
+
+namespace {
+
+// heap allocations of the process (the micro-benchmarks run on one thread)
+long allocations = 0;
+
+struct Measurement {
+  long calls = 0;
+  double seconds = 0.;
+  long allocations = 0;
+};
+
+// times a block of calls and counts its allocations
+template <typename Block>
+void Measure(Measurement& measurement, long calls, Block block)
+{
+  auto allocations_start = allocations;
+  auto start = std::chrono::steady_clock::now();
+  block();
+  std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+  measurement.seconds += time.count();
+  measurement.allocations += allocations - allocations_start;
+  measurement.calls += calls;
+}
+
+void Print(const char* name, const Measurement& measurement)
+{
+  G4cout << std::left << std::setw(40) << name << std::right
+         << std::setw(12) << measurement.calls;
+  // fewer calls than hits per event : nothing measured
+  if (!measurement.calls) {
+    G4cout << std::setw(12) << "-" << std::setw(14) << "-" << G4endl;
+    return;
+  }
+  G4cout << std::setw(12) << std::fixed << std::setprecision(1) 
+         << 1.e9*measurement.seconds/measurement.calls
+         << std::setw(14) << std::setprecision(3)
+         << (double)measurement.allocations/measurement.calls 
+         << std::defaultfloat << G4endl;
+}
+
+}
+
+void* operator new(std::size_t size)
+{
+  ++allocations;
+  if (auto pointer = std::malloc(size ? size : 1)) return pointer;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc,char** argv)
+{
+  long calls = (argc > 1) ? std::atol(argv[1]) : 1000000;
+  G4int hits_per_event = (argc > 2) ? std::atoi(argv[2]) : 4;
+  if (calls <= 0 || hits_per_event <= 0) {
+    G4cerr << "Usage: " << argv[0] << " [calls] [hits per event]" << G4endl;
+    return 1;
+  }
+  long events = calls/hits_per_event;
+
+  // Application with EM physics only, no visualization
+  auto runManager = G4RunManagerFactory::CreateRunManager(G4RunManagerType::Serial);
+  runManager->SetUserInitialization(new DetectorConstruction);
+  auto physicslist = new PhysicsList();
+  physicslist->AddPhysicsList("emstandard_opt0");
+  runManager->SetUserInitialization(physicslist);
+  runManager->SetUserInitialization(new ActionInitialization());
+
+  auto UImanager = G4UImanager::GetUIpointer();
+  UImanager->ApplyCommand("/control/verbose 0");
+  UImanager->ApplyCommand("/run/verbose 0");
+  UImanager->ApplyCommand("/proton_pol/telemetry/interval 0");
+  UImanager->ApplyCommand("/analysis/setFileName proton_pol_microbench");
+  UImanager->ApplyCommand("/run/initialize");
+
+  // open a run: current Run, analysis file and event output
+  runManager->RunInitialization();
+
+  auto sdManager = G4SDManager::GetSDMpointer();
+  auto dcin = static_cast<DriftChamberSD*>(sdManager->FindSensitiveDetector("/dcin"));
+  auto dcout = static_cast<DriftChamberSD*>(sdManager->FindSensitiveDetector("/dcout"));
+
+  // synthetic steps: a primary proton and a delta electron
+  std::vector<G4Track*> tracks;
+  std::vector<G4Step*> steps;
+  for (auto i_track = 0; i_track < 2; ++i_track) {
+    auto definition = i_track ? (G4ParticleDefinition*)G4Electron::Definition() 
+                              : (G4ParticleDefinition*)G4Proton::Definition();
+    auto energy = i_track ? 100.*keV : 180.*MeV;
+    auto direction = G4ThreeVector(0.1, 0.05, 1.).unit();
+    auto track = new G4Track(new G4DynamicParticle(definition, direction, energy),
+                             0., G4ThreeVector(0., 0., 1.5*mm));
+    track->SetTrackID(i_track+1);
+    track->SetParentID(i_track);
+    auto step = new G4Step();
+    auto point = step->GetPreStepPoint();
+    point->SetPosition(G4ThreeVector(3.*mm, 1.5*mm, 1.5*mm));
+    point->SetMomentumDirection(direction);
+    point->SetKineticEnergy(energy);
+    point->SetMass(definition->GetPDGMass());
+    point->SetGlobalTime(0.01*ns);
+    step->SetTrack(track);
+    track->SetStep(step);
+    tracks.push_back(track);
+    steps.push_back(step);
+  }
+
+  G4cout << G4endl
+         << std::left << std::setw(40) << "micro-benchmark" << std::right
+         << std::setw(12) << "calls" << std::setw(12) << "ns/call" 
+         << std::setw(14) << "allocs/call" << G4endl;
+
+  // DriftChamberSD::ProcessHits : hits_per_event steps per event and chamber
+  Measurement process_hits;
+  for (long i_event = 0; i_event < events; ++i_event) {
+    // a fresh G4HCofThisEvent per event, which deletes the hits collections
+    // of the event outside the timed block
+    G4HCofThisEvent hce(sdManager->GetCollectionCapacity());
+    dcin->Initialize(&hce);
+    dcout->Initialize(&hce);
+    Measure(process_hits, 2*hits_per_event, [&]() {
+      for (auto i_hit = 0; i_hit < hits_per_event; ++i_hit) {
+        auto step = steps[i_hit ? 1 : 0];
+        dcin->ProcessHits(step, nullptr);
+        dcout->ProcessHits(step, nullptr);
+      }
+    });
+  }
+  Print("DriftChamberSD::ProcessHits", process_hits);
+
+  // EventAction::EndOfEventAction : on the hit stores left by the last event
+  auto eventAction = const_cast<G4UserEventAction*>(runManager->GetUserEventAction());
+  Measurement end_of_event;
+  {
+    G4Event event(0);
+    eventAction->BeginOfEventAction(&event);
+    const long block = 1000;
+    for (long i_call = 0; i_call < calls/hits_per_event; i_call += block) {
+      Measure(end_of_event, block, [&]() {
+        for (long i = 0; i < block; ++i) eventAction->EndOfEventAction(&event);
+      });
+    }
+  }
+  Print("EventAction::EndOfEventAction", end_of_event);
+
+  // PrimaryGeneratorAction::GeneratePrimaries : into fresh events
+  auto primaryGenerator = const_cast<G4VUserPrimaryGeneratorAction*>(
+      runManager->GetUserPrimaryGeneratorAction());
+  Measurement generate_primaries;
+  {
+    const long block = 1000;
+    std::vector<G4Event*> block_events(block);
+    for (long i_call = 0; i_call < calls/hits_per_event; i_call += block) {
+      for (long i = 0; i < block; ++i) block_events[i] = new G4Event(i_call+i);
+      Measure(generate_primaries, block, [&]() {
+        for (auto event : block_events) primaryGenerator->GeneratePrimaries(event);
+      });
+      for (auto event : block_events) delete event;
+    }
+  }
+  Print("PrimaryGeneratorAction::GeneratePrimaries", generate_primaries);
+
+  // close the run and clean up
+  runManager->RunTermination();
+  for (auto step : steps) delete step;
+  for (auto track : tracks) delete track;
+  delete runManager;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,31 @@
+#!/bin/sh
+# Compares the throughput and the analyzing power of the global
+# (cuts_global.mac) and per-region (cuts_regions.mac) physics configurations.
+#
+# usage: ./region_benchmark.sh [events] [threads] [executable]
+
+EVENTS=${1:-10000}
+THREADS=${2:-1}
+PROGRAM=${3:-./execute-proton_pol}
+
+# analyzing power averaged over the 10-20 deg window (weighted by 1/error^2)
+window_ay() {
+  awk -F, '!/^#/ && $1 >= 10 && $2 <= 20 && $10 > 0 {
+             w = 1./($10*$10); sum += w*$9; sumw += w }
+           END { if (sumw > 0) printf "%.4f +- %.4f", sum/sumw, 1./sqrt(sumw);
+                 else printf "n/a" }' "$1"
+}
+
+for config in global regions; do
+  "$PROGRAM" --macro cuts_$config.mac --events $EVENTS --threads $THREADS \
+    --seed 12345 --timing-report region_$config.txt > region_$config.log 2>&1 \
+    || { echo "$config run failed, see region_$config.log"; exit 1; }
+done
+
+RATE_GLOBAL=$(awk '/^events/ {n = $2} /^wall/ {t = $2} END {print n/t}' region_global.txt)
+RATE_REGIONS=$(awk '/^events/ {n = $2} /^wall/ {t = $2} END {print n/t}' region_regions.txt)
+
+echo "config        events/s   A_y (10-20 deg)"
+printf "global   %12.1f   %s\n" $RATE_GLOBAL "$(window_ay proton_pol_asymmetry_global.csv)"
+printf "regions  %12.1f   %s\n" $RATE_REGIONS "$(window_ay proton_pol_asymmetry_regions.csv)"
+awk -v a=$RATE_GLOBAL -v b=$RATE_REGIONS 'BEGIN { printf "speed-up %12.2f\n", b/a }'
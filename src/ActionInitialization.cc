@@ -31,6 +31,10 @@
 #include "PrimaryGeneratorAction.hh"
 #include "RunAction.hh"
 #include "EventAction.hh"
+#include "StackingAction.hh"
+#include "TrackingAction.hh"
+#include "SteppingAction.hh"
+#include "StartupTimer.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -54,9 +58,20 @@ void ActionInitialization::BuildForMaster() const
 
 void ActionInitialization::Build() const
 {
-  SetUserAction(new PrimaryGeneratorAction);
+  // time the initialization of this worker
+  StartupTimer::Instance()->ObserveStates();
 
-  SetUserAction(new EventAction);
+  auto eventAction = new EventAction;
+
+  SetUserAction(new PrimaryGeneratorAction(eventAction));
+
+  SetUserAction(eventAction);
+
+  SetUserAction(new StackingAction);
+
+  SetUserAction(new TrackingAction(eventAction));
+
+  SetUserAction(new SteppingAction);
 
   SetUserAction(new RunAction);
 }  
@@ -0,0 +1,152 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file AnalyzingPowerTable.cc
+/// \brief Implementation of the AnalyzingPowerTable class
+
+#include "AnalyzingPowerTable.hh"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+// index of the lower grid point and fraction of the interval, clamped
+void Locate(const std::vector<double>& grid, double x, std::size_t& lower, double& fraction)
+{
+  lower = 0;
+  fraction = 0.;
+  if (grid.size() < 2 || x <= grid.front()) return;
+  if (x >= grid.back()) {
+    lower = grid.size() - 2;
+    fraction = 1.;
+    return;
+  }
+  lower = std::upper_bound(grid.begin(), grid.end(), x) - grid.begin() - 1;
+  fraction = (x - grid[lower])/(grid[lower+1] - grid[lower]);
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AnalyzingPowerTable::AnalyzingPowerTable()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AnalyzingPowerTable::~AnalyzingPowerTable()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool AnalyzingPowerTable::Read(const std::string& path)
+{
+  theta_.clear();
+  energy_.clear();
+  values_.clear();
+
+  std::ifstream input(path);
+  if (!input) return false;
+
+  // theta, T, A_y
+  std::vector<std::array<double, 3>> points;
+  std::string line;
+  while (std::getline(input, line)) {
+    if (line.empty() || line[0] == '#') continue;
+
+    // asymmetry CSV : theta_low, theta_high, ..., analyzing_power (9th)
+    auto csv = line.find(',') != std::string::npos;
+    if (csv) std::replace(line.begin(), line.end(), ',', ' ');
+    std::istringstream fields(line);
+    std::vector<double> values;
+    double value;
+    while (fields >> value) values.push_back(value);
+
+    if (csv && values.size() >= 9) {
+      if (values[2] <= 0.) continue;   // empty bin
+      points.push_back({{ 0.5*(values[0] + values[1]), 0., values[8] }});
+    }
+    else if (!csv && values.size() == 2) {
+      points.push_back({{ values[0], 0., values[1] }});
+    }
+    else if (!csv && values.size() == 3) {
+      points.push_back({{ values[0], values[1], values[2] }});
+    }
+    else {
+      return false;
+    }
+  }
+  if (points.empty()) return false;
+
+  // grid of the theta and T values, every node given once
+  for (const auto& point : points) {
+    theta_.push_back(point[0]);
+    energy_.push_back(point[1]);
+  }
+  for (auto grid : { &theta_, &energy_ }) {
+    std::sort(grid->begin(), grid->end());
+    grid->erase(std::unique(grid->begin(), grid->end()), grid->end());
+  }
+  if (points.size() != theta_.size()*energy_.size()) {
+    theta_.clear();
+    energy_.clear();
+    return false;
+  }
+  values_.assign(points.size(), 0.);
+  for (const auto& point : points) {
+    auto i_theta = std::lower_bound(theta_.begin(), theta_.end(), point[0]) - theta_.begin();
+    auto i_energy = std::lower_bound(energy_.begin(), energy_.end(), point[1]) - energy_.begin();
+    values_[i_theta*energy_.size() + i_energy] = point[2];
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+double AnalyzingPowerTable::GetValue(double theta, double energy) const
+{
+  if (theta_.empty()) return 0.;
+
+  std::size_t i_theta, i_energy;
+  double f_theta, f_energy;
+  Locate(theta_, theta, i_theta, f_theta);
+  Locate(energy_, energy, i_energy, f_energy);
+
+  auto nenergy = energy_.size();
+  auto Value = [&](std::size_t i, std::size_t j) {
+    i = std::min(i, theta_.size() - 1);
+    j = std::min(j, nenergy - 1);
+    return values_[i*nenergy + j];
+  };
+  auto low = (1. - f_energy)*Value(i_theta, i_energy) + f_energy*Value(i_theta, i_energy+1);
+  auto high = (1. - f_energy)*Value(i_theta+1, i_energy) + f_energy*Value(i_theta+1, i_energy+1);
+  return (1. - f_theta)*low + f_theta*high;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
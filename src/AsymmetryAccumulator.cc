@@ -0,0 +1,351 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file AsymmetryAccumulator.cc
+/// \brief Implementation of the AsymmetryAccumulator class
+
+#include "AsymmetryAccumulator.hh"
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+
+// variance of the weighted mean of x from sum w, sum w x, sum w^2 x, 
+// sum w^2 x^2 and sum w^2
+double MeanVariance(double sum_w, double sum_wx, double sum_w2x, 
+                    double sum_w2x2, double sum_w2)
+{
+  if (sum_w <= 0.) return 0.;
+  auto mean = sum_wx/sum_w;
+  auto variance 
+    = (sum_w2x2 - 2.*mean*sum_w2x + mean*mean*sum_w2)/(sum_w*sum_w);
+  return variance > 0. ? variance : 0.;
+}
+
+// (n1 - n2)/(n1 + n2) and its error for weighted counts with variances v1, v2
+void Asymmetry(double n1, double v1, double n2, double v2,
+               double& asymmetry, double& error)
+{
+  auto sum = n1 + n2;
+  if (sum <= 0.) {
+    asymmetry = 0.;
+    error = 0.;
+    return;
+  }
+  asymmetry = (n1 - n2)/sum;
+  error = 2.*std::sqrt(n2*n2*v1 + n1*n1*v2)/(sum*sum);
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsymmetryAccumulator::AsymmetryAccumulator(int nbins, double theta_min, double theta_max)
+: nbins_(0), theta_min_(0.), theta_max_(0.), events_(0.)
+{
+  SetBinning(nbins, theta_min, theta_max);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsymmetryAccumulator::~AsymmetryAccumulator()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsymmetryAccumulator::SetBinning(int nbins, double theta_min, double theta_max)
+{
+  nbins_ = nbins > 0 ? nbins : 1;
+  theta_min_ = theta_min;
+  theta_max_ = theta_max > theta_min ? theta_max : theta_min + 1.;
+  Reset();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsymmetryAccumulator::Reset()
+{
+  events_ = 0.;
+  bins_.assign(nbins_, Bin());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsymmetryAccumulator::Fill(double theta, double phi, double weight)
+{
+  if (theta < theta_min_ || theta >= theta_max_) return;
+  FillDirection(theta, std::cos(phi), std::sin(phi), weight);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsymmetryAccumulator::FillDirection(double theta, double cos_phi, double sin_phi, 
+                                         double weight)
+{
+  if (theta < theta_min_ || theta >= theta_max_) return;
+  auto i_bin = (int)((theta - theta_min_)/(theta_max_ - theta_min_)*nbins_);
+  if (i_bin >= nbins_) i_bin = nbins_ - 1;
+
+  // sectors of 90 deg centred on +x, +y, -x, -y
+  int sector;
+  if (std::abs(cos_phi) > std::abs(sin_phi)) sector = cos_phi > 0. ? kPlusX : kMinusX;
+  else sector = sin_phi > 0. ? kPlusY : kMinusY;
+
+  auto weight2 = weight*weight;
+
+  auto& bin = bins_[i_bin];
+  bin.sum_w += weight;
+  bin.sum_w2 += weight2;
+  bin.sector_w[sector] += weight;
+  bin.sector_w2[sector] += weight2;
+  bin.cos_w += weight*cos_phi;
+  bin.cos_w2 += weight2*cos_phi;
+  bin.cos2_w2 += weight2*cos_phi*cos_phi;
+  bin.sin_w += weight*sin_phi;
+  bin.sin_w2 += weight2*sin_phi;
+  bin.sin2_w2 += weight2*sin_phi*sin_phi;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsymmetryAccumulator::Merge(const AsymmetryAccumulator& other)
+{
+  if (other.nbins_ != nbins_) return;
+
+  events_ += other.events_;
+  for (auto i_bin = 0; i_bin < nbins_; ++i_bin) {
+    Add(bins_[i_bin], other.bins_[i_bin]);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsymmetryAccumulator::Result 
+AsymmetryAccumulator::GetResult(int i_bin, double polarization) const
+{
+  auto result = Evaluate(bins_[i_bin], polarization);
+  auto width = (theta_max_ - theta_min_)/nbins_;
+  result.theta_low = theta_min_ + i_bin*width;
+  result.theta_high = result.theta_low + width;
+  return result;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsymmetryAccumulator::Result 
+AsymmetryAccumulator::GetWindowResult(double theta_low, double theta_high, 
+                                      double polarization) const
+{
+  Bin sum = Bin();
+  double fom = 0.;
+  Result result = Result();
+  result.theta_low = theta_high;
+  result.theta_high = theta_low;
+
+  for (auto i_bin = 0; i_bin < nbins_; ++i_bin) {
+    auto bin_result = GetResult(i_bin, polarization);
+    if (bin_result.theta_low < theta_low - 1.e-9 
+        || bin_result.theta_high > theta_high + 1.e-9) continue;
+    Add(sum, bins_[i_bin]);
+    // the figure of merit of independent bins adds up
+    fom += bin_result.fom;
+    if (bin_result.theta_low < result.theta_low) result.theta_low = bin_result.theta_low;
+    if (bin_result.theta_high > result.theta_high) result.theta_high = bin_result.theta_high;
+  }
+
+  auto window = Evaluate(sum, polarization);
+  window.theta_low = result.theta_low;
+  window.theta_high = result.theta_high;
+  window.fom = fom;
+  return window;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsymmetryAccumulator::Print(std::ostream& output, double polarization,
+                                 double window_low, double window_high) const
+{
+  auto flags = output.flags();
+  auto precision = output.precision();
+
+  output << " theta [deg]      counts  eff[%]     eps_LR           eps_UD"
+         << "           A_y              FOM" << std::endl;
+  auto print = [&output](const Result& result) {
+    output << std::fixed << std::setprecision(1)
+           << std::setw(5) << result.theta_low << " - " << std::setw(5) << result.theta_high
+           << std::setw(12) << std::setprecision(0) << result.counts
+           << std::setw(8) << std::setprecision(3) << 100.*result.efficiency
+           << std::setprecision(4)
+           << std::setw(9) << result.eps_lr << " +- " << std::setw(6) << result.eps_lr_error
+           << std::setw(9) << result.eps_ud << " +- " << std::setw(6) << result.eps_ud_error
+           << std::setw(9) << result.analyzing_power 
+           << " +- " << std::setw(6) << result.analyzing_power_error
+           << std::scientific << std::setprecision(3)
+           << std::setw(12) << result.fom << std::endl;
+  };
+
+  for (auto i_bin = 0; i_bin < nbins_; ++i_bin) print(GetResult(i_bin, polarization));
+  output << " window :" << std::endl;
+  auto window = GetWindowResult(window_low, window_high, polarization);
+  print(window);
+  if (window.fom > 0. && events_ > 0.) {
+    output << " expected polarization error 1/sqrt(N x FOM) = "
+           << 1./std::sqrt(events_*window.fom) << std::endl;
+  }
+
+  output.flags(flags);
+  output.precision(precision);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool AsymmetryAccumulator::Write(const std::string& path, double polarization) const
+{
+  std::ofstream output(path);
+  if (!output) return false;
+
+  output << "# incident events (sum of weights) : " << events_ << "\n"
+         << "# beam polarization : " << polarization << "\n"
+         << "# theta_low,theta_high,counts,efficiency,"
+         << "eps_lr,eps_lr_error,eps_ud,eps_ud_error,"
+         << "analyzing_power,analyzing_power_error,"
+         << "sin_asymmetry,sin_asymmetry_error,fom\n";
+  output << std::setprecision(8);
+  for (auto i_bin = 0; i_bin < nbins_; ++i_bin) {
+    auto result = GetResult(i_bin, polarization);
+    output << result.theta_low << "," << result.theta_high << ","
+           << result.counts << "," << result.efficiency << ","
+           << result.eps_lr << "," << result.eps_lr_error << ","
+           << result.eps_ud << "," << result.eps_ud_error << ","
+           << result.analyzing_power << "," << result.analyzing_power_error << ","
+           << result.sin_asymmetry << "," << result.sin_asymmetry_error << ","
+           << result.fom << "\n";
+  }
+  return (bool)output;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool AsymmetryAccumulator::Save(const std::string& path) const
+{
+  std::ofstream output(path);
+  if (!output) return false;
+
+  output << "proton_pol_asymmetry_state 1\n"
+         << std::setprecision(17)
+         << nbins_ << " " << theta_min_ << " " << theta_max_ << " " << events_ << "\n";
+  for (const auto& bin : bins_) {
+    output << bin.sum_w << " " << bin.sum_w2;
+    for (auto i_sector = 0; i_sector < kSectors; ++i_sector) {
+      output << " " << bin.sector_w[i_sector] << " " << bin.sector_w2[i_sector];
+    }
+    output << " " << bin.cos_w << " " << bin.cos_w2 << " " << bin.cos2_w2
+           << " " << bin.sin_w << " " << bin.sin_w2 << " " << bin.sin2_w2 << "\n";
+  }
+  return (bool)output;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool AsymmetryAccumulator::Load(const std::string& path)
+{
+  std::ifstream input(path);
+  std::string magic;
+  int version = 0, nbins = 0;
+  double theta_min = 0., theta_max = 0., events = 0.;
+  if (!(input >> magic >> version >> nbins >> theta_min >> theta_max >> events)
+      || magic != "proton_pol_asymmetry_state" || version != 1 || nbins < 1) {
+    return false;
+  }
+
+  std::vector<Bin> bins(nbins);
+  for (auto& bin : bins) {
+    input >> bin.sum_w >> bin.sum_w2;
+    for (auto i_sector = 0; i_sector < kSectors; ++i_sector) {
+      input >> bin.sector_w[i_sector] >> bin.sector_w2[i_sector];
+    }
+    input >> bin.cos_w >> bin.cos_w2 >> bin.cos2_w2 
+          >> bin.sin_w >> bin.sin_w2 >> bin.sin2_w2;
+  }
+  if (!input) return false;
+
+  SetBinning(nbins, theta_min, theta_max);
+  events_ = events;
+  bins_ = bins;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsymmetryAccumulator::Add(Bin& sum, const Bin& bin) const
+{
+  sum.sum_w += bin.sum_w;
+  sum.sum_w2 += bin.sum_w2;
+  for (auto i_sector = 0; i_sector < kSectors; ++i_sector) {
+    sum.sector_w[i_sector] += bin.sector_w[i_sector];
+    sum.sector_w2[i_sector] += bin.sector_w2[i_sector];
+  }
+  sum.cos_w += bin.cos_w;
+  sum.cos_w2 += bin.cos_w2;
+  sum.cos2_w2 += bin.cos2_w2;
+  sum.sin_w += bin.sin_w;
+  sum.sin_w2 += bin.sin_w2;
+  sum.sin2_w2 += bin.sin2_w2;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsymmetryAccumulator::Result 
+AsymmetryAccumulator::Evaluate(const Bin& bin, double polarization) const
+{
+  Result result = Result();
+  result.counts = bin.sum_w;
+  result.efficiency = events_ > 0. ? bin.sum_w/events_ : 0.;
+
+  Asymmetry(bin.sector_w[kPlusX], bin.sector_w2[kPlusX],
+            bin.sector_w[kMinusX], bin.sector_w2[kMinusX],
+            result.eps_lr, result.eps_lr_error);
+  Asymmetry(bin.sector_w[kPlusY], bin.sector_w2[kPlusY],
+            bin.sector_w[kMinusY], bin.sector_w2[kMinusY],
+            result.eps_ud, result.eps_ud_error);
+
+  if (bin.sum_w > 0. && polarization != 0.) {
+    auto scale = 2./polarization;
+    result.analyzing_power = scale*bin.cos_w/bin.sum_w;
+    result.analyzing_power_error = std::fabs(scale)
+      *std::sqrt(MeanVariance(bin.sum_w, bin.cos_w, bin.cos_w2, bin.cos2_w2, bin.sum_w2));
+    result.sin_asymmetry = scale*bin.sin_w/bin.sum_w;
+    result.sin_asymmetry_error = std::fabs(scale)
+      *std::sqrt(MeanVariance(bin.sum_w, bin.sin_w, bin.sin_w2, bin.sin2_w2, bin.sum_w2));
+  }
+  result.fom = result.efficiency*result.analyzing_power*result.analyzing_power;
+
+  return result;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
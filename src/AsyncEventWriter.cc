@@ -0,0 +1,208 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file AsyncEventWriter.cc
+/// \brief Implementation of the AsyncEventWriter class
+
+#include "AsyncEventWriter.hh"
+#include "EventOutput.hh"
+
+#include <algorithm>
+#include <chrono>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventRing::EventRing(std::size_t capacity)
+: mask_(0), head_(0), tail_(0)
+{
+  std::size_t size = 1;
+  while (size < capacity) size <<= 1;
+  records_.resize(size);
+  mask_ = size - 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EventRing::Push(const EventRecord& record)
+{
+  auto head = head_.load(std::memory_order_relaxed);
+  if (head - tail_.load(std::memory_order_acquire) == records_.size()) return false;
+
+  records_[head & mask_] = record;
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EventRing::Pop(EventRecord& record)
+{
+  auto tail = tail_.load(std::memory_order_relaxed);
+  if (tail == head_.load(std::memory_order_acquire)) return false;
+
+  record = records_[tail & mask_];
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsyncEventWriter::Channel::Channel(std::size_t capacity, ColumnarWriter* columnar_writer,
+                                   BackPressure policy)
+: ring(capacity), writer(columnar_writer), back_pressure(policy),
+  records(0), stalls(0), dropped(0), max_depth(0), depth_sum(0.),
+  batches(0), closing(false), drained(false)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncEventWriter::Channel::Push(const EventRecord& record)
+{
+  auto depth = ring.GetDepth();
+  max_depth = std::max(max_depth, depth);
+  depth_sum += depth;
+  ++records;
+
+  if (ring.Push(record)) return;
+
+  if (back_pressure == kDrop) {
+    ++dropped;
+    return;
+  }
+  ++stalls;
+  while (!ring.Push(record)) std::this_thread::yield();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsyncEventWriter* AsyncEventWriter::fgInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsyncEventWriter* AsyncEventWriter::Instance()
+{
+  // first called by the master RunAction, before the workers start
+  if (!fgInstance) fgInstance = new AsyncEventWriter;
+  return fgInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsyncEventWriter::AsyncEventWriter()
+: stop_(false)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsyncEventWriter::~AsyncEventWriter()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  condition_.notify_all();
+  if (thread_.joinable()) thread_.join();
+  fgInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncEventWriter::Register(Channel* channel)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    channels_.push_back(channel);
+    if (!thread_.joinable()) thread_ = std::thread([this]() { Loop(); });
+  }
+  condition_.notify_all();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncEventWriter::Unregister(Channel* channel)
+{
+  // the last record was pushed before closing is set
+  channel->closing.store(true, std::memory_order_release);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  condition_.notify_all();
+  condition_.wait(lock, [channel]() { return channel->drained; });
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncEventWriter::Loop()
+{
+  // the lock guards the channel list and the drained flags only: the
+  // records are compressed and written without it, so Register() and
+  // Unregister() of the other threads do not wait for the file writes
+  std::vector<Channel*> channels;
+  std::vector<Channel*> closed;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_) {
+    channels = channels_;
+    lock.unlock();
+
+    std::size_t written = 0;
+    closed.clear();
+    for (auto channel : channels) {
+      auto closing = channel->closing.load(std::memory_order_acquire);
+      written += Drain(channel);
+      if (closing && !channel->ring.GetDepth()) closed.push_back(channel);
+    }
+
+    lock.lock();
+    // closed channels are handed back to their threads
+    if (!closed.empty()) {
+      for (auto channel : closed) {
+        channel->drained = true;
+        channels_.erase(std::find(channels_.begin(), channels_.end(), channel));
+      }
+      condition_.notify_all();
+    }
+
+    // idle: poll the rings, the producers do not notify
+    if (!written && !stop_) {
+      condition_.wait_for(lock, std::chrono::microseconds(200));
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::size_t AsyncEventWriter::Drain(Channel* channel)
+{
+  EventRecord record;
+  std::size_t written = 0;
+  while (written < kMaxBatch && channel->ring.Pop(record)) {
+    EventOutput::FillColumnar(*channel->writer, record);
+    ++written;
+  }
+  if (written) ++channel->batches;
+  return written;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
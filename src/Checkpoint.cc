@@ -0,0 +1,294 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file Checkpoint.cc
+/// \brief Implementation of the Checkpoint class
+
+#include "Checkpoint.hh"
+#include "CommandLineOptions.hh"
+#include "Run.hh"
+
+#include "G4StateManager.hh"
+#include "G4UImanager.hh"
+#include "G4UIcommand.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+Checkpoint* Checkpoint::fgInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Checkpoint::Checkpoint(const CommandLineOptions& options)
+: options_(options), directory_(options.GetCheckpoint()), file_("proton_pol"),
+  seed_(0), events_(0), events_done_(0), segment_(0)
+{
+  fgInstance = this;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Checkpoint::~Checkpoint()
+{
+  fgInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int Checkpoint::Execute()
+{
+  auto UImanager = G4UImanager::GetUIpointer();
+
+  // base name of the analysis files, as set by the options and the macro
+  file_ = G4AnalysisManager::Instance()->GetFileName();
+  if (file_.size() > 5 && file_.substr(file_.size()-5) == ".root") {
+    file_ = file_.substr(0, file_.size()-5);
+  }
+
+  columnar_file_ = UImanager->GetCurrentValues("/proton_pol/output/columnarFile");
+
+  mkdir(directory_.c_str(), 0755);
+  if (options_.GetResume()) {
+    if (!Load()) {
+      G4cerr << "Checkpoint: cannot resume from " << directory_ << G4endl;
+      return 1;
+    }
+    G4cout << "Checkpoint: resuming at event " << events_done_ << " of " << events_
+           << ", segment " << segment_ << G4endl;
+  }
+  else {
+    seed_ = options_.GetSeed() ? options_.GetSeed() : (G4long)time(nullptr);
+    events_ = options_.GetEvents();
+  }
+
+  // every event is seeded from (run seed, event ID)
+  UImanager->ApplyCommand("/proton_pol/run/seed " + G4UIcommand::ConvertToString(seed_));
+  UImanager->ApplyCommand("/proton_pol/run/eventSeeding true");
+
+  auto status = 0;
+  if (G4StateManager::GetStateManager()->GetCurrentState() == G4State_PreInit) {
+    status = UImanager->ApplyCommand("/run/initialize");
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  G4long events_start = events_done_;
+  while (status == 0 && events_done_ < events_) {
+    // segment size : fixed, or from the rate of the previous segments
+    G4long segment_events = options_.GetCheckpointEvents();
+    auto minutes = options_.GetCheckpointMinutes();
+    if (minutes > 0. && events_done_ > events_start) {
+      std::chrono::duration<G4double> time = std::chrono::steady_clock::now() - start;
+      segment_events = (G4long)((events_done_ - events_start)/time.count()*minutes*60.);
+    }
+    if (segment_events <= 0) segment_events = (minutes > 0.) ? 1000 : events_/10;
+    segment_events = std::max(1L, std::min(segment_events, events_ - events_done_));
+
+    UImanager->ApplyCommand("/proton_pol/run/eventOffset " 
+                            + G4UIcommand::ConvertToString((G4int)events_done_));
+    UImanager->ApplyCommand("/analysis/setFileName " + GetSegmentFile(file_, segment_));
+    UImanager->ApplyCommand("/proton_pol/output/columnarFile " 
+                            + GetSegmentFile(columnar_file_, segment_));
+    status = UImanager->ApplyCommand("/run/beamOn " 
+                                     + G4UIcommand::ConvertToString((G4int)segment_events));
+  }
+  if (status != 0) {
+    G4cerr << "Checkpoint: run failed with status " << status << G4endl;
+    return 1;
+  }
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Checkpoint::Accumulate(Run* run)
+{
+  auto analysisManager = G4AnalysisManager::Instance();
+
+  // histograms : previous segments + this run
+  auto first_h1 = analysisManager->GetFirstH1Id();
+  auto nof_h1 = analysisManager->GetNofH1s();
+  for (auto i_h1 = 0; i_h1 < nof_h1 && i_h1 < (G4int)h1_.size(); ++i_h1) {
+    analysisManager->GetH1(first_h1 + i_h1)->add(h1_[i_h1]);
+  }
+  h1_.clear();
+  for (auto i_h1 = 0; i_h1 < nof_h1; ++i_h1) {
+    h1_.push_back(*analysisManager->GetH1(first_h1 + i_h1));
+  }
+
+  auto first_h2 = analysisManager->GetFirstH2Id();
+  auto nof_h2 = analysisManager->GetNofH2s();
+  for (auto i_h2 = 0; i_h2 < nof_h2 && i_h2 < (G4int)h2_.size(); ++i_h2) {
+    analysisManager->GetH2(first_h2 + i_h2)->add(h2_[i_h2]);
+  }
+  h2_.clear();
+  for (auto i_h2 = 0; i_h2 < nof_h2; ++i_h2) {
+    h2_.push_back(*analysisManager->GetH2(first_h2 + i_h2));
+  }
+
+  // streaming asymmetry
+  run->GetAsymmetry().Merge(asymmetry_);
+  asymmetry_ = run->GetAsymmetry();
+
+  events_done_ += run->GetNumberOfEvent();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Checkpoint::Commit()
+{
+  // the histograms and the asymmetry of the job so far, in files of this
+  // segment which the previous checkpoint does not reference
+  auto histograms = GetSegmentFile(file_, segment_) + ".root";
+  std::ostringstream asymmetry;
+  asymmetry << "asymmetry_seg" << segment_ << ".state";
+  auto previous_asymmetry = asymmetry_file_;
+  asymmetry_file_ = asymmetry.str();
+  ++segment_;
+
+  std::ostringstream state;
+  state << "proton_pol_checkpoint 2\n"
+        << "seed " << seed_ << "\n"
+        << "events " << events_ << "\n"
+        << "events_done " << events_done_ << "\n"
+        << "segment " << segment_ << "\n"
+        << "histograms " << histograms << "\n"
+        << "asymmetry " << asymmetry_file_ << "\n"
+        << "columnar " << columnar_file_ << "\n";
+
+  // one rename of checkpoint.txt commits the segment
+  G4bool ok = asymmetry_.Save(GetPath(asymmetry_file_))
+           && Sync(GetPath(asymmetry_file_)) && Sync(histograms);
+  ok = ok && WriteAtomically("checkpoint.txt", state.str());
+  if (ok && !previous_asymmetry.empty()) std::remove(GetPath(previous_asymmetry).c_str());
+  if (!ok) {
+    G4ExceptionDescription msg;
+    msg << "Cannot write the checkpoint in " << directory_ << G4endl;
+    G4Exception("Checkpoint::Commit()",
+                "Code001", JustWarning, msg);
+    return;
+  }
+  G4cout << "Checkpoint: " << events_done_ << " of " << events_ 
+         << " events done, written to " << directory_ << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Checkpoint::Load()
+{
+  std::ifstream input(GetPath("checkpoint.txt"));
+  std::string magic, key, histograms, asymmetry, columnar;
+  G4int version = 0;
+  if (!(input >> magic >> version) || magic != "proton_pol_checkpoint" || version != 2) {
+    return false;
+  }
+  while (input >> key) {
+    if (key == "seed") input >> seed_;
+    else if (key == "events") input >> events_;
+    else if (key == "events_done") input >> events_done_;
+    else if (key == "segment") input >> segment_;
+    else if (key == "histograms") input >> histograms;
+    else if (key == "asymmetry") input >> asymmetry;
+    else if (key == "columnar") input >> columnar;
+  }
+  if (histograms.empty() || asymmetry.empty() || !asymmetry_.Load(GetPath(asymmetry))) {
+    return false;
+  }
+  asymmetry_file_ = asymmetry;
+  if (!columnar.empty()) columnar_file_ = columnar;
+
+  // histograms of the last complete segment
+  auto analysisManager = G4AnalysisManager::Instance();
+  auto reader = G4AnalysisReader::Instance();
+  h1_.clear();
+  for (auto i_h1 = 0; i_h1 < analysisManager->GetNofH1s(); ++i_h1) {
+    auto name = analysisManager->GetH1Name(analysisManager->GetFirstH1Id() + i_h1);
+    auto h1 = reader->GetH1(reader->ReadH1(name, histograms), false);
+    if (!h1) return false;
+    h1_.push_back(*h1);
+  }
+  h2_.clear();
+  for (auto i_h2 = 0; i_h2 < analysisManager->GetNofH2s(); ++i_h2) {
+    auto name = analysisManager->GetH2Name(analysisManager->GetFirstH2Id() + i_h2);
+    auto h2 = reader->GetH2(reader->ReadH2(name, histograms), false);
+    if (!h2) return false;
+    h2_.push_back(*h2);
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Checkpoint::WriteAtomically(const G4String& name, const G4String& content) const
+{
+  auto temporary = GetPath(name + ".tmp");
+  {
+    std::ofstream output(temporary);
+    output << content;
+    output.flush();
+    if (!output) return false;
+  }
+  // the content is on disk before the rename, the rename before the return
+  return Sync(temporary)
+      && std::rename(temporary.c_str(), GetPath(name).c_str()) == 0
+      && Sync(directory_);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Checkpoint::Sync(const G4String& path) const
+{
+  auto fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  auto ok = fsync(fd) == 0;
+  close(fd);
+  return ok;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String Checkpoint::GetPath(const G4String& name) const
+{
+  return directory_ + "/" + name;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String Checkpoint::GetSegmentFile(const G4String& file, G4int segment) const
+{
+  std::ostringstream name;
+  name << file << "_seg" << segment;
+  return name.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,238 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ColumnarReader.cc
+/// \brief Implementation of the ColumnarReader class
+
+#include "ColumnarReader.hh"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef PROTON_POL_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+// Bounds checked little-endian read from the mapping
+template <class T>
+bool ReadValue(const unsigned char* data, std::size_t size, 
+               std::size_t& offset, T& value)
+{
+  if (offset > size || sizeof(T) > size - offset) return false;
+  std::memcpy(&value, data + offset, sizeof(T));
+  offset += sizeof(T);
+  return true;
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ColumnarReader::ColumnarReader()
+: data_(nullptr), size_(0), rows_(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ColumnarReader::~ColumnarReader()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarReader::Open(const std::string& path)
+{
+  Close();
+
+  if (!ColumnarHostIsLittleEndian()) return false;
+  auto fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat status;
+  if (::fstat(fd, &status) != 0 || status.st_size == 0) {
+    ::close(fd);
+    return false;
+  }
+  size_ = status.st_size;
+
+  auto mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    size_ = 0;
+    return false;
+  }
+  // scans are sequential over each column
+  ::madvise(mapping, size_, MADV_SEQUENTIAL);
+  data_ = static_cast<const unsigned char*>(mapping);
+
+  if (!ReadHeader() || !ReadFooter()) {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarReader::Close()
+{
+  if (data_) ::munmap(const_cast<unsigned char*>(data_), size_);
+  data_ = nullptr;
+  size_ = 0;
+  rows_ = 0;
+  columns_.clear();
+  blocks_.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int ColumnarReader::GetColumnIndex(const std::string& name) const
+{
+  for (std::size_t i_column = 0; i_column < columns_.size(); ++i_column) {
+    if (columns_[i_column].name == name) return (int)i_column;
+  }
+  return -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const void* ColumnarReader::GetBlockData(std::size_t block, std::size_t column)
+{
+  const auto& index = blocks_[block].columns[column];
+
+  if (index.codec == kCodecNone) return data_ + index.offset;
+
+#ifdef PROTON_POL_WITH_ZLIB
+  if (index.codec == kCodecZlib) {
+    // zlib expands a stream at most about 1032 times: a larger raw size
+    // comes from a corrupt footer
+    if (index.raw_size/1032 > index.stored_size + 1) return nullptr;
+    auto& inflated = columns_[column].inflated;
+    inflated.resize(index.raw_size);
+    auto inflated_size = (uLongf)index.raw_size;
+    if (uncompress(inflated.data(), &inflated_size, 
+                   data_ + index.offset, index.stored_size) != Z_OK
+        || inflated_size != index.raw_size) {
+      return nullptr;
+    }
+    return inflated.data();
+  }
+#endif
+
+  return nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarReader::ReadHeader()
+{
+  if (size_ < sizeof(kColumnarMagic) 
+      || std::memcmp(data_, kColumnarMagic, sizeof(kColumnarMagic)) != 0) {
+    return false;
+  }
+
+  std::size_t offset = sizeof(kColumnarMagic);
+  std::uint32_t version, ncolumns;
+  if (!ReadValue(data_, size_, offset, version) || version != kColumnarVersion) return false;
+  if (!ReadValue(data_, size_, offset, ncolumns)) return false;
+
+  for (std::uint32_t i_column = 0; i_column < ncolumns; ++i_column) {
+    std::uint8_t type, reserved;
+    std::uint16_t length;
+    if (!ReadValue(data_, size_, offset, type)
+        || !ReadValue(data_, size_, offset, reserved)
+        || !ReadValue(data_, size_, offset, length)
+        || ColumnarTypeSize(static_cast<ColumnarType>(type)) == 0
+        || length > size_ - offset) {
+      return false;
+    }
+    Column column;
+    column.name.assign(reinterpret_cast<const char*>(data_ + offset), length);
+    column.type = static_cast<ColumnarType>(type);
+    columns_.push_back(column);
+    offset += length;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarReader::ReadFooter()
+{
+  std::size_t trailer_size = sizeof(std::uint64_t) + sizeof(kColumnarEndMagic);
+  if (size_ < trailer_size 
+      || std::memcmp(data_ + size_ - sizeof(kColumnarEndMagic), 
+                     kColumnarEndMagic, sizeof(kColumnarEndMagic)) != 0) {
+    // not closed properly (e.g. the job was killed)
+    return false;
+  }
+
+  std::size_t offset = size_ - trailer_size;
+  std::uint64_t footer_offset, nblocks;
+  if (!ReadValue(data_, size_, offset, footer_offset)) return false;
+  offset = footer_offset;
+  if (!ReadValue(data_, size_, offset, nblocks)) return false;
+
+  for (std::uint64_t i_block = 0; i_block < nblocks; ++i_block) {
+    BlockIndex block;
+    if (!ReadValue(data_, size_, offset, block.rows)) return false;
+    for (std::size_t i_column = 0; i_column < columns_.size(); ++i_column) {
+      ColumnIndex index;
+      std::uint32_t reserved;
+      if (!ReadValue(data_, size_, offset, index.offset)
+          || !ReadValue(data_, size_, offset, index.stored_size)
+          || !ReadValue(data_, size_, offset, index.raw_size)
+          || !ReadValue(data_, size_, offset, index.codec)
+          || !ReadValue(data_, size_, offset, reserved)
+          || index.offset > footer_offset
+          || index.stored_size > footer_offset - index.offset
+          || (index.codec != kCodecNone && index.codec != kCodecZlib)) {
+        return false;
+      }
+      // raw size of the rows, without overflow; uncompressed payloads are
+      // used in place and must be aligned
+      auto value_size = ColumnarTypeSize(columns_[i_column].type);
+      if (index.raw_size % value_size != 0 || index.raw_size/value_size != block.rows
+          || (index.codec == kCodecNone 
+              && (index.stored_size != index.raw_size || index.offset % 8 != 0))) {
+        return false;
+      }
+      block.columns.push_back(index);
+    }
+    rows_ += block.rows;
+    blocks_.push_back(block);
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,202 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ColumnarScan.cc
+/// \brief Implementation of the ColumnarScan class
+
+#include "ColumnarScan.hh"
+#include "ColumnarReader.hh"
+
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// DCOUT columns of the event output (EventOutput)
+const char* const kColumnNames[] = {
+  "dcout_nhit", "dcout_momentum_x", "dcout_momentum_y", "dcout_momentum_z", "weight"
+};
+enum { kNhit, kMomentumX, kMomentumY, kMomentumZ, kWeight, kColumns };
+
+// proton mass (MeV)
+const double kProtonMass = 938.272;
+
+// arrays of one thread, reused from block to block
+struct Buffers {
+  std::vector<double> px, py, pz, weight;
+  std::vector<double> theta, cos_phi, sin_phi, momentum, energy;
+
+  void Resize(std::size_t rows) {
+    if (px.size() >= rows) return;
+    for (auto array : { &px, &py, &pz, &weight, &theta, &cos_phi, &sin_phi, &momentum, &energy }) {
+      array->resize(rows);
+    }
+  }
+};
+
+// batch of one block, false on a corrupted block
+bool Convert(ColumnarReader& reader, std::size_t block, const int* columns,
+             Buffers& buffers, ScatteringBatch& batch)
+{
+  auto rows = reader.GetBlockRows(block);
+  auto nhit = reader.GetBlockColumn<std::int32_t>(block, columns[kNhit]);
+  auto px = reader.GetBlockColumn<float>(block, columns[kMomentumX]);
+  auto py = reader.GetBlockColumn<float>(block, columns[kMomentumY]);
+  auto pz = reader.GetBlockColumn<float>(block, columns[kMomentumZ]);
+  auto weight = reader.GetBlockColumn<float>(block, columns[kWeight]);
+  if (!nhit || !px || !py || !pz || !weight) return false;
+
+  // rows with a DCOUT hit
+  buffers.Resize(rows);
+  std::size_t size = 0;
+  for (std::size_t i_row = 0; i_row < rows; ++i_row) {
+    buffers.px[size] = px[i_row];
+    buffers.py[size] = py[i_row];
+    buffers.pz[size] = pz[i_row];
+    buffers.weight[size] = weight[i_row];
+    size += nhit[i_row] > 0;
+  }
+
+  // angles as G4ThreeVector::theta() and phi() : theta from the beam (+z),
+  // phi = 0 along +x
+  const double* __restrict__ x = buffers.px.data();
+  const double* __restrict__ y = buffers.py.data();
+  const double* __restrict__ z = buffers.pz.data();
+  double* __restrict__ cos_phi = buffers.cos_phi.data();
+  double* __restrict__ sin_phi = buffers.sin_phi.data();
+  double* __restrict__ momentum = buffers.momentum.data();
+  double* __restrict__ energy = buffers.energy.data();
+  double* __restrict__ theta = buffers.theta.data();
+  for (std::size_t i = 0; i < size; ++i) {
+    auto pt2 = x[i]*x[i] + y[i]*y[i];
+    auto pt = std::sqrt(pt2);
+    auto inverse = pt > 0. ? 1./pt : 0.;
+    cos_phi[i] = pt > 0. ? x[i]*inverse : 1.;
+    sin_phi[i] = y[i]*inverse;
+    momentum[i] = std::sqrt(pt2 + z[i]*z[i]);
+    energy[i] = std::sqrt(pt2 + z[i]*z[i] + kProtonMass*kProtonMass) - kProtonMass;
+  }
+  for (std::size_t i = 0; i < size; ++i) {
+    auto pt = std::sqrt(x[i]*x[i] + y[i]*y[i]);
+    theta[i] = std::atan2(pt, z[i])*(180./M_PI);
+  }
+
+  batch.events = rows;
+  batch.size = size;
+  batch.theta = theta;
+  batch.cos_phi = cos_phi;
+  batch.sin_phi = sin_phi;
+  batch.momentum = momentum;
+  batch.energy = energy;
+  batch.weight = buffers.weight.data();
+  return true;
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ColumnarScan::ColumnarScan(const std::vector<std::string>& files, int threads)
+: files_(files), threads_(threads), rows_(0)
+{
+  if (threads_ <= 0) threads_ = std::thread::hardware_concurrency();
+  if (threads_ <= 0) threads_ = 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ColumnarScan::~ColumnarScan()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarScan::Run(const Function& function)
+{
+  error_.clear();
+  rows_ = 0;
+
+  // blocks of all files, and the DCOUT columns of every file
+  std::vector<Block> blocks;
+  std::vector<std::vector<int>> columns(files_.size(), std::vector<int>(kColumns));
+  for (std::size_t i_file = 0; i_file < files_.size(); ++i_file) {
+    ColumnarReader reader;
+    if (!reader.Open(files_[i_file])) {
+      error_ = "cannot read " + files_[i_file];
+      return false;
+    }
+    for (auto i_column = 0; i_column < kColumns; ++i_column) {
+      auto index = reader.GetColumnIndex(kColumnNames[i_column]);
+      auto type = i_column == kNhit ? kColumnInt32 : kColumnFloat32;
+      if (index < 0 || reader.GetColumnType(index) != type) {
+        error_ = "no column " + std::string(kColumnNames[i_column]) + " in " + files_[i_file];
+        return false;
+      }
+      columns[i_file][i_column] = index;
+    }
+    for (std::size_t i_block = 0; i_block < reader.GetNumberOfBlocks(); ++i_block) {
+      blocks.push_back({ i_file, i_block });
+    }
+    rows_ += reader.GetNumberOfRows();
+  }
+
+  // blocks are taken in turn by the threads
+  std::atomic<std::size_t> next(0);
+  std::mutex error_mutex;
+  auto Work = [&](int thread) {
+    std::vector<std::unique_ptr<ColumnarReader>> readers(files_.size());
+    Buffers buffers;
+    ScatteringBatch batch;
+    for (auto i_block = next++; i_block < blocks.size(); i_block = next++) {
+      const auto& block = blocks[i_block];
+      auto& reader = readers[block.file];
+      if (!reader) {
+        reader.reset(new ColumnarReader);
+        reader->Open(files_[block.file]);
+      }
+      if (!reader->IsOpen() 
+          || !Convert(*reader, block.block, columns[block.file].data(), buffers, batch)) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        error_ = "corrupted block in " + files_[block.file];
+        continue;
+      }
+      function(thread, batch);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (auto i_thread = 1; i_thread < threads_; ++i_thread) {
+    threads.emplace_back(Work, i_thread);
+  }
+  Work(0);
+  for (auto& thread : threads) thread.join();
+
+  return error_.empty();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,262 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ColumnarWriter.cc
+/// \brief Implementation of the ColumnarWriter class
+
+#include "ColumnarWriter.hh"
+
+#include <cstring>
+
+#ifdef PROTON_POL_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ColumnarWriter::ColumnarWriter()
+: file_(nullptr), codec_(kCodecNone), block_rows_(0), rows_(0), offset_(0),
+  raw_bytes_(0), stored_bytes_(0), write_error_(false)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ColumnarWriter::~ColumnarWriter()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int ColumnarWriter::AddColumn(const std::string& name, ColumnarType type)
+{
+  if (file_) return -1;
+
+  Column column;
+  column.name = name;
+  column.type = type;
+  column.size = ColumnarTypeSize(type);
+  columns_.push_back(column);
+  return (int)columns_.size() - 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarWriter::Open(const std::string& path, ColumnarCodec codec,
+                          std::size_t block_rows)
+{
+  Close();
+
+  if (!ColumnarHostIsLittleEndian()) return false;
+  file_ = std::fopen(path.c_str(), "wb");
+  if (!file_) return false;
+
+#ifdef PROTON_POL_WITH_ZLIB
+  codec_ = codec;
+#else
+  codec_ = kCodecNone;
+  (void)codec;
+#endif
+  block_rows_ = block_rows > 0 ? block_rows : 1;
+  rows_ = 0;
+  offset_ = 0;
+  raw_bytes_ = 0;
+  stored_bytes_ = 0;
+  write_error_ = false;
+  blocks_.clear();
+  for (auto& column : columns_) {
+    column.buffer.clear();
+    column.buffer.reserve(block_rows_*column.size);
+  }
+
+  return WriteHeader();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarWriter::Close()
+{
+  if (!file_) return true;
+
+  // includes the blocks flushed by AddRow()
+  auto ok = FlushBlock() && WriteFooter() && !write_error_;
+  ok = (std::fclose(file_) == 0) && ok;
+  file_ = nullptr;
+  return ok;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarWriter::Fill(int column, double value)
+{
+  auto& col = columns_[column];
+  col.buffer.resize((rows_+1)*col.size);
+  auto destination = &col.buffer[rows_*col.size];
+
+  switch (col.type) {
+    case kColumnInt32: {
+      auto converted = (std::int32_t)value;
+      std::memcpy(destination, &converted, col.size);
+      break;
+    }
+    case kColumnFloat32: {
+      auto converted = (float)value;
+      std::memcpy(destination, &converted, col.size);
+      break;
+    }
+    case kColumnFloat64: {
+      std::memcpy(destination, &value, col.size);
+      break;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarWriter::AddRow()
+{
+  ++rows_;
+  // columns not filled in this row are zero
+  for (auto& column : columns_) column.buffer.resize(rows_*column.size);
+
+  if (rows_ == block_rows_) FlushBlock();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarWriter::WriteHeader()
+{
+  auto ok = WriteBytes(kColumnarMagic, sizeof(kColumnarMagic));
+  std::uint32_t version = kColumnarVersion;
+  std::uint32_t ncolumns = columns_.size();
+  ok = ok && WriteBytes(&version, sizeof(version));
+  ok = ok && WriteBytes(&ncolumns, sizeof(ncolumns));
+  for (const auto& column : columns_) {
+    std::uint8_t type = column.type;
+    std::uint8_t reserved = 0;
+    std::uint16_t length = column.name.size();
+    ok = ok && WriteBytes(&type, sizeof(type));
+    ok = ok && WriteBytes(&reserved, sizeof(reserved));
+    ok = ok && WriteBytes(&length, sizeof(length));
+    ok = ok && WriteBytes(column.name.data(), length);
+  }
+  return ok && WritePadding(ColumnarPadding(offset_));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarWriter::FlushBlock()
+{
+  if (rows_ == 0) return true;
+
+  BlockIndex block;
+  block.rows = rows_;
+
+  auto ok = true;
+  for (auto& column : columns_) {
+    ColumnIndex index;
+    index.offset = offset_;
+    index.raw_size = column.buffer.size();
+    index.codec = kCodecNone;
+
+    const unsigned char* payload = column.buffer.data();
+    std::size_t payload_size = column.buffer.size();
+
+#ifdef PROTON_POL_WITH_ZLIB
+    if (codec_ == kCodecZlib) {
+      auto bound = compressBound(column.buffer.size());
+      compressed_.resize(bound);
+      auto compressed_size = (uLongf)bound;
+      // fastest level: the files are written from the event loop
+      if (compress2(compressed_.data(), &compressed_size, 
+                    column.buffer.data(), column.buffer.size(), 1) == Z_OK
+          && compressed_size < column.buffer.size()) {
+        payload = compressed_.data();
+        payload_size = compressed_size;
+        index.codec = kCodecZlib;
+      }
+    }
+#endif
+
+    index.stored_size = payload_size;
+    ok = ok && WriteBytes(payload, payload_size);
+    ok = ok && WritePadding(ColumnarPadding(payload_size));
+    block.columns.push_back(index);
+
+    raw_bytes_ += index.raw_size;
+    stored_bytes_ += index.stored_size;
+    column.buffer.clear();
+  }
+  blocks_.push_back(block);
+  rows_ = 0;
+
+  return ok;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarWriter::WriteFooter()
+{
+  std::uint64_t footer_offset = offset_;
+  std::uint64_t nblocks = blocks_.size();
+  std::uint32_t reserved = 0;
+
+  auto ok = WriteBytes(&nblocks, sizeof(nblocks));
+  for (const auto& block : blocks_) {
+    ok = ok && WriteBytes(&block.rows, sizeof(block.rows));
+    for (const auto& index : block.columns) {
+      ok = ok && WriteBytes(&index.offset, sizeof(index.offset));
+      ok = ok && WriteBytes(&index.stored_size, sizeof(index.stored_size));
+      ok = ok && WriteBytes(&index.raw_size, sizeof(index.raw_size));
+      ok = ok && WriteBytes(&index.codec, sizeof(index.codec));
+      ok = ok && WriteBytes(&reserved, sizeof(reserved));
+    }
+  }
+  ok = ok && WriteBytes(&footer_offset, sizeof(footer_offset));
+  return ok && WriteBytes(kColumnarEndMagic, sizeof(kColumnarEndMagic));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarWriter::WriteBytes(const void* data, std::size_t size)
+{
+  if (size == 0) return true;
+  // the offsets of the footer are invalid after a failed write
+  if (write_error_) return false;
+  offset_ += size;
+  if (std::fwrite(data, 1, size, file_) != size) write_error_ = true;
+  return !write_error_;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarWriter::WritePadding(std::size_t size)
+{
+  static const unsigned char zeros[8] = { 0 };
+  return WriteBytes(zeros, size);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
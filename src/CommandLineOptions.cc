@@ -0,0 +1,237 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file CommandLineOptions.cc
+/// \brief Implementation of the CommandLineOptions class
+
+#include "CommandLineOptions.hh"
+
+#include "G4UIcommand.hh"
+#include "G4ios.hh"
+
+#include <cstdlib>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CommandLineOptions::CommandLineOptions()
+: macro_(""), run_manager_("default"),
+  threads_(0), events_(0), seed_(0),
+  event_seeding_(false), replay_event_(-1),
+  momentum_(0.), physics_list_("QGSP_BERT_HP"), output_(""),
+  scaling_threads_(0), processes_(0), 
+  checkpoint_(""), checkpoint_events_(0), checkpoint_minutes_(0.), resume_(false),
+  timing_report_(""), startup_report_(""),
+  help_(false)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CommandLineOptions::~CommandLineOptions()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CommandLineOptions::Parse(G4int argc, char** argv)
+{
+  for (auto i_arg = 1; i_arg < argc; ++i_arg) {
+    G4String arg = argv[i_arg];
+
+    // options without value
+    if (arg == "-h" || arg == "--help") {
+      help_ = true;
+      continue;
+    }
+    if (arg == "--event-seeding") {
+      event_seeding_ = true;
+      continue;
+    }
+    if (arg == "--resume") {
+      resume_ = true;
+      continue;
+    }
+    if (arg[0] != '-') {
+      macro_ = arg;
+      continue;
+    }
+
+    // options with value
+    if (i_arg+1 >= argc) {
+      G4cerr << "proton_pol: option " << arg << " requires a value" << G4endl;
+      return false;
+    }
+    G4String value = argv[++i_arg];
+
+    if (arg == "-m" || arg == "--macro") {
+      macro_ = value;
+    }
+    else if (arg == "-r" || arg == "--run-manager") {
+      run_manager_ = value;
+    }
+    else if (arg == "-t" || arg == "--threads") {
+      threads_ = std::atoi(value.c_str());
+    }
+    else if (arg == "-n" || arg == "--events") {
+      events_ = std::atoi(value.c_str());
+    }
+    else if (arg == "-s" || arg == "--seed") {
+      seed_ = std::atol(value.c_str());
+    }
+    else if (arg == "--replay-event") {
+      replay_event_ = std::atoi(value.c_str());
+    }
+    else if (arg == "-p" || arg == "--momentum") {
+      momentum_ = std::atof(value.c_str());
+    }
+    else if (arg == "-l" || arg == "--physics") {
+      physics_list_ = value;
+    }
+    else if (arg == "-o" || arg == "--output") {
+      output_ = value;
+    }
+    else if (arg == "--scaling") {
+      scaling_threads_ = std::atoi(value.c_str());
+    }
+    else if (arg == "--processes") {
+      processes_ = std::atoi(value.c_str());
+    }
+    else if (arg == "--checkpoint") {
+      checkpoint_ = value;
+    }
+    else if (arg == "--checkpoint-every") {
+      checkpoint_events_ = std::atol(value.c_str());
+    }
+    else if (arg == "--checkpoint-minutes") {
+      checkpoint_minutes_ = std::atof(value.c_str());
+    }
+    else if (arg == "--timing-report") {
+      timing_report_ = value;
+    }
+    else if (arg == "--startup-report") {
+      startup_report_ = value;
+    }
+    else {
+      G4cerr << "proton_pol: unknown option " << arg << G4endl;
+      return false;
+    }
+  }
+
+  // a replay is one event with event seeding
+  if (replay_event_ >= 0) {
+    event_seeding_ = true;
+    events_ = 1;
+  }
+
+  if (resume_ && checkpoint_.empty()) {
+    G4cerr << "proton_pol: --resume requires --checkpoint dir" << G4endl;
+    return false;
+  }
+
+  if (run_manager_ != "default" && run_manager_ != "serial" 
+      && run_manager_ != "mt" && run_manager_ != "tasking") {
+    G4cerr << "proton_pol: unknown run manager " << run_manager_ << G4endl;
+    return false;
+  }
+
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CommandLineOptions::PrintUsage(const char* program) const
+{
+  G4cout << "Usage: " << program << " [options] [macro]" << G4endl
+         << " -m, --macro file        macro executed before the run" << G4endl
+         << " -r, --run-manager type  serial, mt, tasking or default" << G4endl
+         << " -t, --threads n         number of worker threads" << G4endl
+         << " -n, --events n          number of events" << G4endl
+         << " -s, --seed n            fixed random seed" << G4endl
+         << "     --event-seeding     seed every event from (seed, event ID)" << G4endl
+         << "     --replay-event id   replay one event (event seeding, verbose)" << G4endl
+         << " -p, --momentum p        beam momentum in MeV/c" << G4endl
+         << " -l, --physics name      physics list (default QGSP_BERT_HP)" << G4endl
+         << " -o, --output name       base name of the event output files" << G4endl
+         << "     --scaling n         thread-scaling benchmark up to n threads" << G4endl
+         << "     --processes n       fork n processes after init (batch only)" << G4endl
+         << "     --checkpoint dir    checkpointed job, state in dir (batch only)" << G4endl
+         << "     --checkpoint-every n     events per checkpoint" << G4endl
+         << "     --checkpoint-minutes m   minutes per checkpoint" << G4endl
+         << "     --resume            resume the checkpointed job (batch only)" << G4endl
+         << "     --timing-report f   file for the run timing report" << G4endl
+         << "     --startup-report f  file for the startup timing report (JSON)" << G4endl
+         << " -h, --help              print this message" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CommandLineOptions::IsInteractive() const
+{
+  return macro_.empty() && events_ == 0 && scaling_threads_ == 0 && !resume_;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<G4String> CommandLineOptions::GetCommands() const
+{
+  // UI commands applied before the macro (forwarded to the workers)
+  std::vector<G4String> commands;
+  if (seed_) {
+    commands.push_back("/proton_pol/run/seed " 
+                       + G4UIcommand::ConvertToString(seed_));
+  }
+  if (event_seeding_) {
+    commands.push_back("/proton_pol/run/eventSeeding true");
+  }
+  if (replay_event_ >= 0) {
+    commands.push_back("/proton_pol/run/replayEvent "
+                       + G4UIcommand::ConvertToString(replay_event_));
+  }
+  if (!timing_report_.empty()) {
+    commands.push_back("/proton_pol/run/timingReport " + timing_report_);
+  }
+  if (momentum_ > 0.) {
+    commands.push_back("/proton_pol/generator/momentum "
+                       + G4UIcommand::ConvertToString(momentum_) + " MeV");
+  }
+  if (!output_.empty()) {
+    commands.push_back("/analysis/setFileName " + output_);
+    commands.push_back("/proton_pol/output/columnarFile " + output_);
+  }
+  return commands;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4RunManagerType CommandLineOptions::GetRunManagerType() const
+{
+  // forked processes replace the threads
+  if (processes_ > 0) return G4RunManagerType::Serial;
+  if (run_manager_ == "serial") return G4RunManagerType::Serial;
+  if (run_manager_ == "mt") return G4RunManagerType::MT;
+  if (run_manager_ == "tasking") return G4RunManagerType::Tasking;
+  return G4RunManagerType::Default;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
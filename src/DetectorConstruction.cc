@@ -29,6 +29,9 @@
 
 #include "DetectorConstruction.hh"
 #include "DriftChamberSD.hh"
+#include "TargetBiasingOperator.hh"
+#include "StartupTimer.hh"
+#include "Constants.hh"
 
 #include "G4FieldManager.hh"
 #include "G4TransportationManager.hh"
@@ -48,6 +51,7 @@
 #include "G4PVParameterised.hh"
 #include "G4PVReplica.hh"
 #include "G4UserLimits.hh"
+#include "G4Region.hh"
 
 #include "G4SDManager.hh"
 #include "G4VSensitiveDetector.hh"
@@ -66,14 +70,18 @@
 
 DetectorConstruction::DetectorConstruction()
   : G4VUserDetectorConstruction(), 
+  fMessenger(nullptr),
+  target_logical_(nullptr),
   dcin_wireplane_logical_(nullptr), dcout_wireplane_logical_(nullptr)
 {
+  // define commands for this class
+  DefineCommands();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 DetectorConstruction::~DetectorConstruction()
 {
-  //delete fMessenger;
+  delete fMessenger;
 
   for (auto visAttributes: fVisAttributes) {
     delete visAttributes;
@@ -84,8 +92,13 @@ DetectorConstruction::~DetectorConstruction()
 
 G4VPhysicalVolume* DetectorConstruction::Construct()
 {
+  StartupTimer::Scope timer("Construct");
+
   // Construct materials
-  ConstructMaterials();
+  {
+    StartupTimer::Scope materials_timer("ConstructMaterials");
+    ConstructMaterials();
+  }
   auto air = G4Material::GetMaterial("G4_AIR");
   auto vacuum = G4Material::GetMaterial("G4_Galactic");
   auto argonGas = G4Material::GetMaterial("G4_Ar");
@@ -95,6 +108,7 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
   auto carbon = G4Material::GetMaterial("G4_C");
 
   // Option to switch on/off checking of volumes overlaps
+  // (after the placements, timed as its own startup phase)
   //
   G4bool checkOverlaps = true;
 
@@ -107,7 +121,7 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
     = new G4LogicalVolume(worldSolid,vacuum,"worldLogical");
   auto worldPhysical
     = new G4PVPlacement(0,G4ThreeVector(),worldLogical,"worldPhysical",0,
-        false,0,checkOverlaps);
+        false,0,false);
 
   // target 
   auto target_size_x = 50.*mm;
@@ -115,11 +129,11 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
   auto target_thickness = 2.*mm; 
   auto targetSolid 
     = new G4Box("targetBox",target_size_x/2.,target_size_y/2.,target_thickness/2.);
-  auto targetLogical
+  target_logical_
     = new G4LogicalVolume(targetSolid,carbon,"targetLogical");
   auto targetPhysical
-    = new G4PVPlacement(0,G4ThreeVector(),targetLogical,"targetPhysical",
-        worldLogical,false,0,checkOverlaps);
+    = new G4PVPlacement(0,G4ThreeVector(),target_logical_,"targetPhysical",
+        worldLogical,false,0,false);
 
   // drift chamber (in)
   auto dc_size_x = target_size_x;
@@ -132,7 +146,7 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
     = new G4LogicalVolume(dcin_Solid,air,"dcin_Logical");
   auto dcin_Physical
     = new G4PVPlacement(0,dcin_position,dcin_Logical,"dcin_Physical",
-        worldLogical,false,0,checkOverlaps);
+        worldLogical,false,0,false);
   // wireplane
   auto dc_wireplane_thickness = 1.*nm;
   auto dcin_wireplane_solid
@@ -141,7 +155,7 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
     = new G4LogicalVolume(dcin_wireplane_solid,argonGas,"dcin_wireplane_logical");
   auto dcin_wireplane_physical
     = new G4PVPlacement(0,G4ThreeVector(),dcin_wireplane_logical_,"dcin_wireplane_physical",
-        dcin_Logical, false,0,checkOverlaps);
+        dcin_Logical, false,0,false);
 
   // drift chamber (out)
   auto dcout_position = -dcin_position;
@@ -151,7 +165,7 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
     = new G4LogicalVolume(dcout_Solid,air,"dcout_Logical");
   auto dcout_Physical
     = new G4PVPlacement(0,dcout_position,dcout_Logical,"dcout_Physical", 
-        worldLogical, false,0,checkOverlaps);
+        worldLogical, false,0,false);
   // wireplane
   auto dcout_wireplane_solid
     = new G4Box("dcout_wireplane_box", dc_size_x/2., dc_size_y/2., dc_wireplane_thickness/2.);
@@ -159,8 +173,24 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
     = new G4LogicalVolume(dcout_wireplane_solid,argonGas,"dcout_wireplane_logical");
   auto dcout_wireplane_physical
     = new G4PVPlacement(0,G4ThreeVector(),dcout_wireplane_logical_,"dcout_wireplane_physical",
-        dcout_Logical, false,0,checkOverlaps);
-
+        dcout_Logical, false,0,false);
+
+  if (checkOverlaps) {
+    StartupTimer::Scope overlaps_timer("CheckOverlaps");
+    for (auto placement : { targetPhysical, dcin_Physical, dcin_wireplane_physical,
+                            dcout_Physical, dcout_wireplane_physical }) {
+      placement->CheckOverlaps();
+    }
+  }
+
+  // regions -----------------------------------------------------------------
+  // own production cuts and EM option (/proton_pol/RegionCut, RegionEm);
+  // the rest of the world is DefaultRegionForTheWorld
+  auto targetRegion = new G4Region("Target");
+  targetRegion->AddRootLogicalVolume(target_logical_);
+  auto dcRegion = new G4Region("DriftChambers");
+  dcRegion->AddRootLogicalVolume(dcin_Logical);
+  dcRegion->AddRootLogicalVolume(dcout_Logical);
 
   // visualization attributes ------------------------------------------------
 
@@ -170,7 +200,7 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
   fVisAttributes.push_back(visAttributes);
 
   visAttributes = new G4VisAttributes(G4Colour::Blue());
-  targetLogical->SetVisAttributes(visAttributes);
+  target_logical_->SetVisAttributes(visAttributes);
   fVisAttributes.push_back(visAttributes);
 
   visAttributes = new G4VisAttributes(G4Colour::Yellow());
@@ -193,18 +223,24 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
 
 void DetectorConstruction::ConstructSDandField()
 {
+  StartupTimer::Scope timer("ConstructSDandField");
+
   auto sdManager = G4SDManager::GetSDMpointer();
   G4String SDname;
 
   // sensitive detectors -----------------------------------------------------
-  auto dcin = new DriftChamberSD(SDname="/dcin");
+  auto dcin = new DriftChamberSD(SDname="/dcin", kDCINId);
   sdManager->AddNewDetector(dcin);
   dcin_wireplane_logical_->SetSensitiveDetector(dcin);
 
-  auto dcout = new DriftChamberSD(SDname="/dcout");
+  auto dcout = new DriftChamberSD(SDname="/dcout", kDCOUTId);
   sdManager->AddNewDetector(dcout);
   dcout_wireplane_logical_->SetSensitiveDetector(dcout);
 
+  // biasing -----------------------------------------------------------------
+  // (inactive unless the proton processes are wrapped, see /proton_pol/Biasing)
+  auto biasingOperator = new TargetBiasingOperator("proton");
+  biasingOperator->AttachTo(target_logical_);
 }    
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -241,3 +277,84 @@ void DetectorConstruction::ConstructMaterials()
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetHitPolicy(const G4String& policy)
+{
+  if (policy == "all") {
+    DriftChamberSD::SetRecordPolicy(kRecordAllSteps);
+  } else if (policy == "first") {
+    DriftChamberSD::SetRecordPolicy(kRecordFirstCrossing);
+  } else if (policy == "primary") {
+    DriftChamberSD::SetRecordPolicy(kRecordPrimaryOnly);
+  } else if (policy == "firstN") {
+    DriftChamberSD::SetRecordPolicy(kRecordFirstN);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetMaxHits(G4int max_hits)
+{
+  DriftChamberSD::SetMaxHitsPerChamber(max_hits);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetBiasingFactor(G4double factor)
+{
+  TargetBiasingOperator::SetFactor(factor);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::DefineCommands()
+{
+  // Define /proton_pol/detector command directory using generic messenger class
+  fMessenger 
+    = new G4GenericMessenger(this, 
+        "/proton_pol/detector/", 
+        "Detector control");
+
+  // hitPolicy command
+  // (the policy is a static of DriftChamberSD shared by all threads,
+  //  so the command is executed on master only)
+  auto& policyCmd
+    = fMessenger->DeclareMethod("hitPolicy", 
+        &DetectorConstruction::SetHitPolicy, 
+        "Hit recording policy of the drift chambers.");
+  G4String guidance
+    = "all     : one hit per charged step\n";
+  guidance 
+    += "first   : first step of each track only\n";
+  guidance 
+    += "primary : steps of primary tracks only\n";
+  guidance 
+    += "firstN  : first N steps of the event in each chamber (see maxHits)";
+  policyCmd.SetGuidance(guidance);
+  policyCmd.SetParameterName("policy", false);
+  policyCmd.SetCandidates("all first primary firstN");
+  policyCmd.SetStates(G4State_PreInit, G4State_Idle);
+  policyCmd.SetToBeBroadcasted(false);
+
+  // maxHits command
+  auto& maxHitsCmd
+    = fMessenger->DeclareMethod("maxHits", 
+        &DetectorConstruction::SetMaxHits, 
+        "Maximum number of hits per event and chamber (firstN policy).");
+  maxHitsCmd.SetParameterName("n", false);
+  maxHitsCmd.SetRange("n>=1");
+  maxHitsCmd.SetStates(G4State_PreInit, G4State_Idle);
+  maxHitsCmd.SetToBeBroadcasted(false);
+
+  // biasingFactor command
+  auto& biasingCmd
+    = fMessenger->DeclareMethod("biasingFactor", 
+        &DetectorConstruction::SetBiasingFactor, 
+        "Cross section factor of the primary proton hadronic processes in the target.");
+  biasingCmd.SetParameterName("factor", false);
+  biasingCmd.SetRange("factor>0.");
+  biasingCmd.SetStates(G4State_PreInit, G4State_Idle);
+  biasingCmd.SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
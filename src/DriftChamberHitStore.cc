@@ -0,0 +1,74 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file DriftChamberHitStore.cc
+/// \brief Implementation of the DriftChamberHitStore class
+
+#include "DriftChamberHitStore.hh"
+
+namespace {
+
+// initial capacity of the columns (hits per event and chamber)
+constexpr std::size_t kReservedHits = 64;
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ThreadLocal DriftChamberHitStore* DriftChamberHitStore::fgInstances[kTotalDCs] = { nullptr };
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+DriftChamberHitStore* DriftChamberHitStore::Instance(G4int chamber_id)
+{
+  if (!fgInstances[chamber_id]) {
+    fgInstances[chamber_id] = new DriftChamberHitStore;
+  }
+  return fgInstances[chamber_id];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+DriftChamberHitStore::DriftChamberHitStore()
+{
+  x_.reserve(kReservedHits);
+  y_.reserve(kReservedHits);
+  z_.reserve(kReservedHits);
+  px_.reserve(kReservedHits);
+  py_.reserve(kReservedHits);
+  pz_.reserve(kReservedHits);
+  time_.reserve(kReservedHits);
+  track_id_.reserve(kReservedHits);
+  parent_id_.reserve(kReservedHits);
+  particle_id_.reserve(kReservedHits);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+DriftChamberHitStore::~DriftChamberHitStore()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -29,19 +29,30 @@
 
 #include "DriftChamberSD.hh"
 #include "DriftChamberHit.hh"
+#include "Run.hh"
 
 #include "G4HCofThisEvent.hh"
 #include "G4TouchableHistory.hh"
 #include "G4Track.hh"
 #include "G4Step.hh"
 #include "G4SDManager.hh"
+#include "G4RunManager.hh"
+#include "G4VVisManager.hh"
 #include "G4ios.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-DriftChamberSD::DriftChamberSD(G4String name)
+DriftChamberRecordPolicy DriftChamberSD::fgRecordPolicy = kRecordAllSteps;
+G4int DriftChamberSD::fgMaxHitsPerChamber = 1;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+DriftChamberSD::DriftChamberSD(G4String name, G4int chamber_id)
 : G4VSensitiveDetector(name), 
-  fHitsCollection(nullptr), fHCID(-1)
+  fHitsCollection(nullptr), fHCID(-1),
+  hit_store_(DriftChamberHitStore::Instance(chamber_id)),
+  charged_steps_(0),
+  last_recorded_track_(0)
 {
   collectionName.insert("dc_hitcollection");
 }
@@ -62,6 +73,10 @@ void DriftChamberSD::Initialize(G4HCofThisEvent* hce)
      fHCID = G4SDManager::GetSDMpointer()->GetCollectionID(fHitsCollection); 
   }
   hce->AddHitsCollection(fHCID,fHitsCollection);
+
+  hit_store_->Clear();
+  charged_steps_ = 0;
+  last_recorded_track_ = 0;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -73,16 +88,26 @@ G4bool DriftChamberSD::ProcessHits(G4Step* step, G4TouchableHistory*)
   auto charge = track->GetDefinition()->GetPDGCharge();
   if (charge==0.) return true;
 
+  ++charged_steps_;
+  if (!AcceptStep(track)) return true;
+
   auto particle_id = track->GetParticleDefinition()->GetPDGEncoding();
   //if(particle_id != 2212) return true;
   
   auto preStepPoint = step->GetPreStepPoint();
+  auto global_position = preStepPoint->GetPosition();
+
+  hit_store_->Add(global_position, preStepPoint->GetMomentum(),
+                  preStepPoint->GetGlobalTime(), track->GetTrackID(),
+                  track->GetParentID(), particle_id);
+
+  // full hit objects for visualization only
+  if (!G4VVisManager::GetConcreteInstance()) return true;
 
   auto touchable = step->GetPreStepPoint()->GetTouchable();
   auto motherPhysical = touchable->GetVolume(1); // mother
   auto copyNo = motherPhysical->GetCopyNo();
 
-  auto global_position = preStepPoint->GetPosition();
   auto local_position
     = touchable->GetHistory()->GetTopTransform().TransformPoint(global_position);
 
@@ -102,3 +127,31 @@ G4bool DriftChamberSD::ProcessHits(G4Step* step, G4TouchableHistory*)
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DriftChamberSD::EndOfEvent(G4HCofThisEvent*)
+{
+  auto run = static_cast<Run*>(
+      G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  if (run) run->AddDriftChamberSteps(charged_steps_, hit_store_->GetSize());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool DriftChamberSD::AcceptStep(const G4Track* track)
+{
+  switch (fgRecordPolicy) {
+    case kRecordFirstCrossing:
+      if (track->GetTrackID() == last_recorded_track_) return false;
+      last_recorded_track_ = track->GetTrackID();
+      return true;
+    case kRecordPrimaryOnly:
+      return track->GetParentID() == 0;
+    case kRecordFirstN:
+      return hit_store_->GetSize() < (std::size_t)fgMaxHitsPerChamber;
+    case kRecordAllSteps:
+    default:
+      return true;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -28,16 +28,19 @@
 /// \brief Implementation of the EventAction class
 
 #include "EventAction.hh"
-#include "DriftChamberHit.hh"
+#include "Run.hh"
+#include "DriftChamberHitStore.hh"
+#include "EventOutput.hh"
+#include "EventSkim.hh"
+#include "Telemetry.hh"
+#include "Snapshot.hh"
+#include "LiveHistograms.hh"
 #include "Constants.hh"
 #include "Analysis.hh"
 
 #include "G4Event.hh"
 #include "G4RunManager.hh"
 #include "G4EventManager.hh"
-#include "G4HCofThisEvent.hh"
-#include "G4VHitsCollection.hh"
-#include "G4SDManager.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4ios.hh"
 
@@ -45,37 +48,13 @@ using std::array;
 using std::vector;
 
 
-namespace {
-
-// Utility function which finds a hit collection with the given Id
-// and print warnings if not found 
-G4VHitsCollection* GetHC(const G4Event* event, G4int collId) {
-  auto hce = event->GetHCofThisEvent();
-  if (!hce) {
-      G4ExceptionDescription msg;
-      msg << "No hits collection of this event found." << G4endl; 
-      G4Exception("EventAction::EndOfEventAction()",
-                  "Code001", JustWarning, msg);
-      return nullptr;
-  }
-
-  auto hc = hce->GetHC(collId);
-  if ( ! hc) {
-    G4ExceptionDescription msg;
-    msg << "Hits collection " << collId << " of this event not found." << G4endl; 
-    G4Exception("EventAction::EndOfEventAction()",
-                "Code001", JustWarning, msg);
-  }
-  return hc;  
-}
-
-}
-
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 EventAction::EventAction()
 : G4UserEventAction(), 
-  dc_hitcollection_id_{{ -1, -1 }}
+  dc_hit_store_{{ nullptr, nullptr }},
+  primary_weight_(1.),
+  print_progress_(1)
 {
   // set printing per each event
   G4RunManager::GetRunManager()->SetPrintProgress(1);
@@ -90,17 +69,14 @@ EventAction::~EventAction()
 
 void EventAction::BeginOfEventAction(const G4Event*)
 {
-  // Find hit collections and histogram Ids by names (just once)
+  primary_weight_ = 1.;
+
+  // Find hit stores and histogram Ids by names (just once)
   // and save them in the data members of this class
 
-  if (dc_hitcollection_id_[0] == -1) {
-    auto sdManager = G4SDManager::GetSDMpointer();
+  if (dc_hit_store_[0] == nullptr) {
     auto analysisManager = G4AnalysisManager::Instance();
 
-    // hits collections names
-    array<G4String, kTotalDCs> dc_hitcollection_name 
-      = {{ "dcin/dc_hitcollection", "dcout/dc_hitcollection" }};
-
     // histograms names
     array<array<G4String, kTotalDCs>, kTotalHistogramsForDC> dc_histogram_name 
       = {{ {{ "dcin_numhit", "dcout_numhit" }},
@@ -115,8 +91,8 @@ void EventAction::BeginOfEventAction(const G4Event*)
         "analysis_theta_vs_sinphi" }};
 
     for (auto i_dc = 0; i_dc < kTotalDCs; ++i_dc) {
-      // hit collections IDs
-      dc_hitcollection_id_[i_dc] = sdManager->GetCollectionID(dc_hitcollection_name[i_dc]);
+      // hit stores (filled by DriftChamberSD of this thread)
+      dc_hit_store_[i_dc] = DriftChamberHitStore::Instance(i_dc);
 
       // histograms IDs
       dc_histogram_id_[0][i_dc] = analysisManager->GetH1Id(dc_histogram_name[0][i_dc]);
@@ -142,6 +118,9 @@ void EventAction::EndOfEventAction(const G4Event* event)
   // Get analysis manager
   auto analysisManager = G4AnalysisManager::Instance();
 
+  // event weight of every fill and row (biasing)
+  G4double weight = primary_weight_;
+
   // ======================================================
   // DCIN =================================================
   // ======================================================
@@ -150,20 +129,17 @@ void EventAction::EndOfEventAction(const G4Event* event)
   G4ThreeVector dcin_momentum = G4ThreeVector(0);
   G4bool dcin_has_hit = false;
 
-  auto dcin_hc = GetHC(event,dc_hitcollection_id_[kDCINId]); 
-  if(dcin_hc){
-    dcin_total_hits = dcin_hc->GetSize();
-    analysisManager->FillH1(dc_histogram_id_[0][kDCINId], dcin_total_hits );
-
-    if(dcin_total_hits>0){
-      dcin_has_hit = true;
-      auto hit = static_cast<DriftChamberHit*>(dcin_hc->GetHit(0));
-      dcin_position = hit->GetGlobalPosition();
-      dcin_momentum = hit->GetMomentum();
-      analysisManager->FillH1(dc_histogram_id_[1][kDCINId], dcin_momentum.theta()/deg);
-      analysisManager->FillH2(dc_histogram_id_[2][kDCINId], dcin_position.x(), dcin_position.y());
-    }
+  auto dcin_store = dc_hit_store_[kDCINId];
+  dcin_total_hits = dcin_store->GetSize();
+
+  if(dcin_total_hits>0){
+    dcin_has_hit = true;
+    dcin_position = dcin_store->GetPosition(0);
+    dcin_momentum = dcin_store->GetMomentum(0);
+    analysisManager->FillH1(dc_histogram_id_[1][kDCINId], dcin_momentum.theta()/deg, weight);
+    analysisManager->FillH2(dc_histogram_id_[2][kDCINId], dcin_position.x(), dcin_position.y(), weight);
   }
+  analysisManager->FillH1(dc_histogram_id_[0][kDCINId], dcin_total_hits, weight);
   // ======================================================
   // ======================================================
 
@@ -177,20 +153,17 @@ void EventAction::EndOfEventAction(const G4Event* event)
   G4ThreeVector dcout_momentum = G4ThreeVector(0);
   G4bool dcout_has_hit = false;
 
-  auto dcout_hc = GetHC(event,dc_hitcollection_id_[kDCOUTId]); 
-  if(dcout_hc){
-    dcout_total_hits = dcout_hc->GetSize();
-    analysisManager->FillH1(dc_histogram_id_[0][kDCOUTId], dcout_total_hits );
-
-    if(dcout_total_hits>0){
-      dcout_has_hit = true;
-      auto hit = static_cast<DriftChamberHit*>(dcout_hc->GetHit(0));
-      dcout_position = hit->GetGlobalPosition();
-      dcout_momentum = hit->GetMomentum();
-      analysisManager->FillH1(dc_histogram_id_[1][kDCINId], dcout_momentum.theta()/deg);
-      analysisManager->FillH2(dc_histogram_id_[2][kDCINId], dcout_position.x(), dcout_position.y());
-    }
+  auto dcout_store = dc_hit_store_[kDCOUTId];
+  dcout_total_hits = dcout_store->GetSize();
+
+  if(dcout_total_hits>0){
+    dcout_has_hit = true;
+    dcout_position = dcout_store->GetPosition(0);
+    dcout_momentum = dcout_store->GetMomentum(0);
+    analysisManager->FillH1(dc_histogram_id_[1][kDCOUTId], dcout_momentum.theta()/deg, weight);
+    analysisManager->FillH2(dc_histogram_id_[2][kDCOUTId], dcout_position.x(), dcout_position.y(), weight);
   }
+  analysisManager->FillH1(dc_histogram_id_[0][kDCOUTId], dcout_total_hits, weight);
   // ======================================================
   // ======================================================
 
@@ -198,17 +171,22 @@ void EventAction::EndOfEventAction(const G4Event* event)
   // ======================================================
   // Analysis =============================================
   // ======================================================
+  auto run = static_cast<Run*>(
+      G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  run->GetAsymmetry().AddEvent(1.);
   if(dcout_has_hit){
     G4double momentum = dcout_momentum.mag()/MeV;
     G4double theta = dcout_momentum.theta()/deg;
     G4double phi   = dcout_momentum.phi()/deg;
-    if(10.<theta&&theta<20.){
-      analysisManager->FillH1(analysis_histogram_id_[0], theta);
-      analysisManager->FillH1(analysis_histogram_id_[1], phi);
-      analysisManager->FillH1(analysis_histogram_id_[2], cos(phi*deg));
-      analysisManager->FillH1(analysis_histogram_id_[3], sin(phi*deg));
-      analysisManager->FillH2(analysis_histogram_id_[4], theta, cos(phi*deg));
-      analysisManager->FillH2(analysis_histogram_id_[5], theta, sin(phi*deg));
+    run->GetAsymmetry().Fill(theta, dcout_momentum.phi(), weight);
+    run->AddWeight(weight);
+    if(kAnalysisThetaMin<theta&&theta<kAnalysisThetaMax){
+      analysisManager->FillH1(analysis_histogram_id_[0], theta, weight);
+      analysisManager->FillH1(analysis_histogram_id_[1], phi, weight);
+      analysisManager->FillH1(analysis_histogram_id_[2], cos(phi*deg), weight);
+      analysisManager->FillH1(analysis_histogram_id_[3], sin(phi*deg), weight);
+      analysisManager->FillH2(analysis_histogram_id_[4], theta, cos(phi*deg), weight);
+      analysisManager->FillH2(analysis_histogram_id_[5], theta, sin(phi*deg), weight);
     }
   }
   // ======================================================
@@ -218,25 +196,22 @@ void EventAction::EndOfEventAction(const G4Event* event)
   // ======================================================
   // Fill Tree ============================================
   // ======================================================
-  if(dcin_has_hit){
-    analysisManager->FillNtupleIColumn(0,dcin_total_hits);
-    analysisManager->FillNtupleFColumn(1,(G4float)dcin_position.x());
-    analysisManager->FillNtupleFColumn(2,(G4float)dcin_position.y());
-    analysisManager->FillNtupleFColumn(3,(G4float)dcin_position.z());
-    analysisManager->FillNtupleFColumn(4,(G4float)dcin_momentum.x());
-    analysisManager->FillNtupleFColumn(5,(G4float)dcin_momentum.y());
-    analysisManager->FillNtupleFColumn(6,(G4float)dcin_momentum.z());
+  EventRecord record = {};
+  record.dcin_nhit = dcin_total_hits;
+  record.dcout_nhit = dcout_total_hits;
+  for (auto i = 0; i < 3; ++i) {
+    record.dcin_position[i] = dcin_position[i];
+    record.dcin_momentum[i] = dcin_momentum[i];
+    record.dcout_position[i] = dcout_position[i];
+    record.dcout_momentum[i] = dcout_momentum[i];
   }
-  if(dcout_has_hit){
-    analysisManager->FillNtupleIColumn(7,dcout_total_hits);
-    analysisManager->FillNtupleFColumn(8,(G4float)dcout_position.x());
-    analysisManager->FillNtupleFColumn(9,(G4float)dcout_position.y());
-    analysisManager->FillNtupleFColumn(10,(G4float)dcout_position.z());
-    analysisManager->FillNtupleFColumn(11,(G4float)dcout_momentum.x());
-    analysisManager->FillNtupleFColumn(12,(G4float)dcout_momentum.y());
-    analysisManager->FillNtupleFColumn(13,(G4float)dcout_momentum.z());
+  record.weight = weight;
+
+  // only the events selected by the skim are written
+  G4int dcout_particle = dcout_has_hit ? dcout_store->GetParticleID()[0] : 0;
+  if (EventSkim::Instance()->Select(record, dcout_particle, run)) {
+    EventOutput::Instance()->Write(record);
   }
-  analysisManager->AddNtupleRow();
   // ======================================================
   // ======================================================
 
@@ -249,16 +224,38 @@ void EventAction::EndOfEventAction(const G4Event* event)
   //if ( printModulo == 0 || event->GetEventID() % printModulo != 0) return;
 
   // Drift chambers
-  //for (G4int i_dc = 0; i_dc < kNumberofDCs; ++i_dc) {
-  //  auto hc = GetHC(event, dc_hitcollection_id_[i_dc]);
-  //  if ( ! hc ) return;
-  //  G4cout << "Drift Chamber " << i_dc + 1 << " has " <<  hc->GetSize()  << " hits." << G4endl;
+  //for (G4int i_dc = 0; i_dc < kTotalDCs; ++i_dc) {
+  //  G4cout << "Drift Chamber " << i_dc + 1 << " has " 
+  //         << dc_hit_store_[i_dc]->GetSize() << " hits." << G4endl;
   //}
 
-  // set printing per each event
-  if(event->GetEventID()){
-    G4int print_progress = (G4int)log10(event->GetEventID());
-    G4RunManager::GetRunManager()->SetPrintProgress(pow(10,print_progress));
+  // busy time of this thread
+  std::chrono::duration<G4double> event_time
+    = std::chrono::steady_clock::now() - event_start_;
+  run->AddBusyTime(event_time.count());
+
+  // live telemetry counters of this thread
+  Telemetry::Instance()->AddEvent(dcin_total_hits + dcout_total_hits);
+
+  // copies of the histograms and the asymmetry for the in-flight snapshots
+  Snapshot::Instance()->Publish(run);
+
+  // copies of the histograms in the live shared memory segment
+  LiveHistograms::Instance()->Publish(run);
+
+  // print progress every 10^n events (n = digits of the event ID - 1),
+  // updated at the decades only; off while the telemetry reports the progress
+  auto event_id = event->GetEventID();
+  if (Telemetry::Instance()->IsEnabled()) {
+    if (print_progress_) {
+      print_progress_ = 0;
+      G4RunManager::GetRunManager()->SetPrintProgress(0);
+    }
+  }
+  else if (event_id < print_progress_ || event_id >= 10*print_progress_) {
+    print_progress_ = 1;
+    while (event_id >= 10*print_progress_) print_progress_ *= 10;
+    G4RunManager::GetRunManager()->SetPrintProgress((G4int)print_progress_);
   }
 }
 
@@ -0,0 +1,289 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EventOutput.cc
+/// \brief Implementation of the EventOutput class
+
+#include "EventOutput.hh"
+#include "ColumnarWriter.hh"
+#include "Analysis.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4Threading.hh"
+#include "G4ios.hh"
+
+#include <sstream>
+#include <algorithm>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ThreadLocal EventOutput* EventOutput::fgInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventOutput* EventOutput::Instance()
+{
+  if (!fgInstance) fgInstance = new EventOutput;
+  return fgInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventOutput::EventOutput()
+: messenger_(nullptr),
+  format_("root"),
+  columnar_file_("proton_pol"),
+  compression_("none"),
+  block_rows_(65536),
+  columnar_writer_(nullptr),
+  async_(false),
+  queue_depth_(4096),
+  back_pressure_("block"),
+  channel_(nullptr)
+{
+  // same columns (and column ids) as the EventTree ntuple
+  columnar_writer_ = new ColumnarWriter;
+  columnar_writer_->AddColumn("dcin_nhit", kColumnInt32);         // column Id = 0
+  columnar_writer_->AddColumn("dcin_position_x", kColumnFloat32); // column Id = 1
+  columnar_writer_->AddColumn("dcin_position_y", kColumnFloat32); // column Id = 2
+  columnar_writer_->AddColumn("dcin_position_z", kColumnFloat32); // column Id = 3
+  columnar_writer_->AddColumn("dcin_momentum_x", kColumnFloat32); // column Id = 4
+  columnar_writer_->AddColumn("dcin_momentum_y", kColumnFloat32); // column Id = 5
+  columnar_writer_->AddColumn("dcin_momentum_z", kColumnFloat32); // column Id = 6
+  columnar_writer_->AddColumn("dcout_nhit", kColumnInt32);        // column Id = 7
+  columnar_writer_->AddColumn("dcout_position_x", kColumnFloat32);// column Id = 8
+  columnar_writer_->AddColumn("dcout_position_y", kColumnFloat32);// column Id = 9
+  columnar_writer_->AddColumn("dcout_position_z", kColumnFloat32);// column Id =10
+  columnar_writer_->AddColumn("dcout_momentum_x", kColumnFloat32);// column Id =11
+  columnar_writer_->AddColumn("dcout_momentum_y", kColumnFloat32);// column Id =12
+  columnar_writer_->AddColumn("dcout_momentum_z", kColumnFloat32);// column Id =13
+  columnar_writer_->AddColumn("weight", kColumnFloat32);          // column Id =14
+
+  // define commands for this class
+  DefineCommands();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventOutput::~EventOutput()
+{
+  delete columnar_writer_;
+  delete messenger_;
+  fgInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventOutput::OpenRun(G4int run_id)
+{
+  if (!IsColumnarEnabled()) return;
+
+  std::ostringstream file_name;
+  file_name << columnar_file_ << "_run" << run_id 
+            << "_t" << std::max(0, G4Threading::G4GetThreadId()) << ".ppcol";
+
+  auto codec = (compression_ == "zlib") ? kCodecZlib : kCodecNone;
+  if (!columnar_writer_->Open(file_name.str(), codec, block_rows_)) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open columnar output " << file_name.str() << G4endl;
+    G4Exception("EventOutput::OpenRun()",
+                "Code001", JustWarning, msg);
+    return;
+  }
+  if (codec != columnar_writer_->GetCodec() && G4Threading::G4GetThreadId() <= 0) {
+    G4ExceptionDescription msg;
+    msg << "Built without zlib: the columnar output is not compressed." << G4endl;
+    G4Exception("EventOutput::OpenRun()",
+                "Code001", JustWarning, msg);
+  }
+
+  if (!async_) return;
+  auto policy 
+    = (back_pressure_ == "drop") ? AsyncEventWriter::kDrop : AsyncEventWriter::kBlock;
+  channel_ = new AsyncEventWriter::Channel(queue_depth_, columnar_writer_, policy);
+  AsyncEventWriter::Instance()->Register(channel_);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventOutput::Write(const EventRecord& record)
+{
+  if (IsRootEnabled()) WriteRoot(record);
+  if (IsColumnarEnabled()) WriteColumnar(record);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventOutput::CloseRun()
+{
+  if (!columnar_writer_->IsOpen()) return;
+
+  if (channel_) {
+    AsyncEventWriter::Instance()->Unregister(channel_);
+    PrintQueueStatistics();
+    delete channel_;
+    channel_ = nullptr;
+  }
+
+  if (!columnar_writer_->Close()) {
+    G4ExceptionDescription msg;
+    msg << "Error while writing the columnar output." << G4endl;
+    G4Exception("EventOutput::CloseRun()",
+                "Code001", JustWarning, msg);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventOutput::WriteRoot(const EventRecord& record)
+{
+  auto analysisManager = G4AnalysisManager::Instance();
+
+  analysisManager->FillNtupleIColumn(0,record.dcin_nhit);
+  analysisManager->FillNtupleFColumn(1,record.dcin_position[0]);
+  analysisManager->FillNtupleFColumn(2,record.dcin_position[1]);
+  analysisManager->FillNtupleFColumn(3,record.dcin_position[2]);
+  analysisManager->FillNtupleFColumn(4,record.dcin_momentum[0]);
+  analysisManager->FillNtupleFColumn(5,record.dcin_momentum[1]);
+  analysisManager->FillNtupleFColumn(6,record.dcin_momentum[2]);
+  analysisManager->FillNtupleIColumn(7,record.dcout_nhit);
+  analysisManager->FillNtupleFColumn(8,record.dcout_position[0]);
+  analysisManager->FillNtupleFColumn(9,record.dcout_position[1]);
+  analysisManager->FillNtupleFColumn(10,record.dcout_position[2]);
+  analysisManager->FillNtupleFColumn(11,record.dcout_momentum[0]);
+  analysisManager->FillNtupleFColumn(12,record.dcout_momentum[1]);
+  analysisManager->FillNtupleFColumn(13,record.dcout_momentum[2]);
+  analysisManager->FillNtupleFColumn(14,record.weight);
+  analysisManager->AddNtupleRow();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventOutput::WriteColumnar(const EventRecord& record)
+{
+  if (channel_) channel_->Push(record);
+  else if (columnar_writer_->IsOpen()) FillColumnar(*columnar_writer_, record);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventOutput::FillColumnar(ColumnarWriter& writer, const EventRecord& record)
+{
+  writer.Fill(0,record.dcin_nhit);
+  for (auto i = 0; i < 3; ++i) {
+    writer.Fill(1+i,record.dcin_position[i]);
+    writer.Fill(4+i,record.dcin_momentum[i]);
+  }
+  writer.Fill(7,record.dcout_nhit);
+  for (auto i = 0; i < 3; ++i) {
+    writer.Fill(8+i,record.dcout_position[i]);
+    writer.Fill(11+i,record.dcout_momentum[i]);
+  }
+  writer.Fill(14,record.weight);
+  writer.AddRow();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventOutput::PrintQueueStatistics() const
+{
+  auto records = channel_->records;
+  G4cout << "--> Asynchronous output: " << records << " records in "
+         << channel_->batches << " batches, queue depth mean "
+         << (records ? channel_->depth_sum/records : 0.)
+         << " max " << channel_->max_depth 
+         << " of " << channel_->ring.GetCapacity()
+         << ", " << channel_->stalls << " stalls, " 
+         << channel_->dropped << " dropped" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventOutput::DefineCommands()
+{
+  // Define /proton_pol/output command directory using generic messenger class
+  messenger_ 
+    = new G4GenericMessenger(this, 
+        "/proton_pol/output/", 
+        "Event output control");
+
+  // format command
+  auto& formatCmd
+    = messenger_->DeclareProperty("format", format_, 
+        "Event output backend : root, columnar, both or none.");
+  formatCmd.SetParameterName("format", false);
+  formatCmd.SetCandidates("root columnar both none");
+  formatCmd.SetStates(G4State_PreInit, G4State_Idle);
+
+  // columnarFile command
+  auto& fileCmd
+    = messenger_->DeclareProperty("columnarFile", columnar_file_, 
+        "Base name of the columnar files (<name>_run<run>_t<thread>.ppcol).");
+  fileCmd.SetParameterName("name", false);
+  fileCmd.SetStates(G4State_PreInit, G4State_Idle);
+
+  // compression command
+  auto& compressionCmd
+    = messenger_->DeclareProperty("compression", compression_, 
+        "Block compression of the columnar files : none or zlib.");
+  compressionCmd.SetParameterName("codec", false);
+  compressionCmd.SetCandidates("none zlib");
+  compressionCmd.SetStates(G4State_PreInit, G4State_Idle);
+
+  // blockRows command
+  auto& blockCmd
+    = messenger_->DeclareProperty("blockRows", block_rows_, 
+        "Number of rows per block of the columnar files.");
+  blockCmd.SetParameterName("rows", false);
+  blockCmd.SetRange("rows>=1");
+  blockCmd.SetStates(G4State_PreInit, G4State_Idle);
+
+  // async command
+  auto& asyncCmd
+    = messenger_->DeclareProperty("async", async_, 
+        "Write the columnar files from a dedicated writer thread.");
+  asyncCmd.SetParameterName("async", true);
+  asyncCmd.SetDefaultValue("true");
+  asyncCmd.SetStates(G4State_PreInit, G4State_Idle);
+
+  // queueDepth command
+  auto& queueCmd
+    = messenger_->DeclareProperty("queueDepth", queue_depth_, 
+        "Records in the ring buffer of each thread (asynchronous output).");
+  queueCmd.SetParameterName("records", false);
+  queueCmd.SetRange("records>=1");
+  queueCmd.SetStates(G4State_PreInit, G4State_Idle);
+
+  // backPressure command
+  auto& pressureCmd
+    = messenger_->DeclareProperty("backPressure", back_pressure_, 
+        "Full ring buffer : block (wait for the writer) or drop the record.");
+  pressureCmd.SetParameterName("policy", false);
+  pressureCmd.SetCandidates("block drop");
+  pressureCmd.SetStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
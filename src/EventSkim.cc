@@ -0,0 +1,235 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EventSkim.cc
+/// \brief Implementation of the EventSkim class
+
+#include "EventSkim.hh"
+#include "Run.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4ParticleTable.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <cmath>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+
+inline G4double Theta(const EventRecord& record)
+{
+  auto& p = record.dcout_momentum;
+  return std::atan2(std::sqrt(p[0]*p[0] + p[1]*p[1]), p[2]);
+}
+
+inline G4double Momentum(const EventRecord& record)
+{
+  auto& p = record.dcout_momentum;
+  return std::sqrt(p[0]*p[0] + p[1]*p[1] + p[2]*p[2]);
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ThreadLocal EventSkim* EventSkim::fgInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventSkim* EventSkim::Instance()
+{
+  if (!fgInstance) fgInstance = new EventSkim;
+  return fgInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventSkim::EventSkim()
+: messenger_(nullptr),
+  require_dcin_(false), require_dcout_(false), particle_(""),
+  theta_min_(0.), theta_max_(180.*deg),
+  momentum_min_(0.), momentum_max_(0.)
+{
+  // define commands for this class
+  DefineCommands();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventSkim::~EventSkim()
+{
+  delete messenger_;
+  fgInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventSkim::Compile()
+{
+  cuts_.clear();
+
+  if (require_dcin_) {
+    cuts_.push_back({"DCIN hit", 
+        [](const EventRecord& record, G4int) { return record.dcin_nhit > 0; }});
+  }
+
+  // the DCOUT rules need a DCOUT hit
+  auto particle_rule = !particle_.empty() && particle_ != "none";
+  auto dcout_rules = particle_rule || theta_min_ > 0. || theta_max_ < 180.*deg
+                  || momentum_min_ > 0. || momentum_max_ > 0.;
+  if (require_dcout_ || dcout_rules) {
+    cuts_.push_back({"DCOUT hit", 
+        [](const EventRecord& record, G4int) { return record.dcout_nhit > 0; }});
+  }
+
+  if (particle_rule) {
+    auto definition = G4ParticleTable::GetParticleTable()->FindParticle(particle_);
+    if (definition) {
+      auto encoding = definition->GetPDGEncoding();
+      cuts_.push_back({"particle " + particle_, 
+          [encoding](const EventRecord&, G4int particle) { return particle == encoding; }});
+    }
+    else {
+      G4ExceptionDescription msg;
+      msg << "Unknown particle " << particle_ << ", no particle selection." << G4endl;
+      G4Exception("EventSkim::Compile()",
+                  "Code001", JustWarning, msg);
+    }
+  }
+
+  if (theta_min_ > 0. || theta_max_ < 180.*deg) {
+    std::ostringstream name;
+    name << theta_min_/deg << " < theta < " << theta_max_/deg << " deg";
+    auto theta_min = theta_min_, theta_max = theta_max_;
+    cuts_.push_back({name.str(), 
+        [theta_min, theta_max](const EventRecord& record, G4int) 
+        { auto theta = Theta(record); return theta_min < theta && theta < theta_max; }});
+  }
+
+  if (momentum_min_ > 0. || momentum_max_ > 0.) {
+    std::ostringstream name;
+    name << "p > " << momentum_min_/MeV << " MeV";
+    if (momentum_max_ > 0.) name << ", p < " << momentum_max_/MeV << " MeV";
+    auto momentum_min = momentum_min_, momentum_max = momentum_max_;
+    cuts_.push_back({name.str(), 
+        [momentum_min, momentum_max](const EventRecord& record, G4int) 
+        { auto momentum = Momentum(record); 
+          return momentum > momentum_min && (momentum_max <= 0. || momentum < momentum_max); }});
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EventSkim::Select(const EventRecord& record, G4int dcout_particle, Run* run) const
+{
+  run->AddCutflow(0);
+  for (std::size_t i_cut = 0; i_cut < cuts_.size(); ++i_cut) {
+    if (!cuts_[i_cut].pass(record, dcout_particle)) return false;
+    run->AddCutflow(i_cut+1);
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<G4String> EventSkim::GetStageNames() const
+{
+  std::vector<G4String> names(1, "all events");
+  for (const auto& cut : cuts_) names.push_back(cut.name);
+  return names;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventSkim::DefineCommands()
+{
+  // Define /proton_pol/skim command directory using generic messenger class
+  messenger_ 
+    = new G4GenericMessenger(this, 
+        "/proton_pol/skim/", 
+        "Selection of the events written to the event output");
+
+  // requireDCIN command
+  auto& dcinCmd
+    = messenger_->DeclareProperty("requireDCIN", require_dcin_, 
+        "Write only events with a DCIN hit.");
+  dcinCmd.SetParameterName("require", true);
+  dcinCmd.SetDefaultValue("true");
+  dcinCmd.SetStates(G4State_PreInit, G4State_Idle);
+
+  // requireDCOUT command
+  auto& dcoutCmd
+    = messenger_->DeclareProperty("requireDCOUT", require_dcout_, 
+        "Write only events with a DCOUT hit.");
+  dcoutCmd.SetParameterName("require", true);
+  dcoutCmd.SetDefaultValue("true");
+  dcoutCmd.SetStates(G4State_PreInit, G4State_Idle);
+
+  // particle command
+  auto& particleCmd
+    = messenger_->DeclareProperty("particle", particle_, 
+        "Particle of the first DCOUT hit (none : any particle).");
+  particleCmd.SetParameterName("particle", true);
+  particleCmd.SetDefaultValue("none");
+  particleCmd.SetStates(G4State_PreInit, G4State_Idle);
+
+  // thetaMin command
+  auto& thetaMinCmd
+    = messenger_->DeclarePropertyWithUnit("thetaMin", "deg", theta_min_, 
+        "Minimum polar angle of the DCOUT momentum.");
+  thetaMinCmd.SetParameterName("theta", false);
+  thetaMinCmd.SetRange("theta>=0.");
+  thetaMinCmd.SetStates(G4State_PreInit, G4State_Idle);
+
+  // thetaMax command
+  auto& thetaMaxCmd
+    = messenger_->DeclarePropertyWithUnit("thetaMax", "deg", theta_max_, 
+        "Maximum polar angle of the DCOUT momentum (180 deg : no limit).");
+  thetaMaxCmd.SetParameterName("theta", false);
+  thetaMaxCmd.SetRange("theta>0.");
+  thetaMaxCmd.SetStates(G4State_PreInit, G4State_Idle);
+
+  // momentumMin command
+  auto& momentumMinCmd
+    = messenger_->DeclarePropertyWithUnit("momentumMin", "MeV", momentum_min_, 
+        "Minimum DCOUT momentum.");
+  momentumMinCmd.SetParameterName("momentum", false);
+  momentumMinCmd.SetRange("momentum>=0.");
+  momentumMinCmd.SetStates(G4State_PreInit, G4State_Idle);
+
+  // momentumMax command
+  auto& momentumMaxCmd
+    = messenger_->DeclarePropertyWithUnit("momentumMax", "MeV", momentum_max_, 
+        "Maximum DCOUT momentum (0 : no limit).");
+  momentumMaxCmd.SetParameterName("momentum", false);
+  momentumMaxCmd.SetRange("momentum>=0.");
+  momentumMaxCmd.SetStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,268 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ForkedJob.cc
+/// \brief Implementation of the ForkedJob class
+
+#include "ForkedJob.hh"
+#include "CommandLineOptions.hh"
+#include "Analysis.hh"
+#include "LiveHistograms.hh"
+
+#include "G4RunManager.hh"
+#include "G4StateManager.hh"
+#include "G4UImanager.hh"
+#include "G4UIcommand.hh"
+#include "G4ios.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fcntl.h>
+#include <glob.h>
+#include <sstream>
+#include <sys/wait.h>
+#include <unistd.h>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ForkedJob::ForkedJob(const G4String& program, const CommandLineOptions& options)
+: program_(program), options_(options)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ForkedJob::~ForkedJob()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ForkedJob::Execute()
+{
+  auto UImanager = G4UImanager::GetUIpointer();
+  auto processes = options_.GetProcesses();
+  auto events = options_.GetEvents();
+
+  // one run seed, every process seeds its own event IDs
+  G4long seed = options_.GetSeed() ? options_.GetSeed() : (G4long)time(nullptr);
+  UImanager->ApplyCommand("/proton_pol/run/seed " + G4UIcommand::ConvertToString(seed));
+  UImanager->ApplyCommand("/proton_pol/run/eventSeeding true");
+
+  // initialize once: geometry and physics tables
+  auto status = 0;
+  if (G4StateManager::GetStateManager()->GetCurrentState() == G4State_PreInit) {
+    status = UImanager->ApplyCommand("/run/initialize");
+  }
+  if (status == 0) status = UImanager->ApplyCommand("/run/beamOn 0");
+  if (status != 0) {
+    G4cerr << "ForkedJob: initialization failed with status " << status << G4endl;
+    return 1;
+  }
+
+  // base names of the outputs, as set by the options and the macro
+  file_ = G4AnalysisManager::Instance()->GetFileName();
+  if (file_.size() > 5 && file_.substr(file_.size()-5) == ".root") {
+    file_ = file_.substr(0, file_.size()-5);
+  }
+  columnar_file_ = UImanager->GetCurrentValues("/proton_pol/output/columnarFile");
+  asymmetry_file_ = UImanager->GetCurrentValues("/proton_pol/asymmetry/file");
+  polarization_ = UImanager->GetCurrentValues("/proton_pol/asymmetry/beamPolarization");
+
+  G4cout << "ForkedJob: " << events << " events in " << processes 
+         << " processes, run seed " << seed << G4endl;
+  std::fflush(stdout);
+  std::cout.flush();
+
+  // fork the children, each with a contiguous range of event IDs
+  std::vector<pid_t> children;
+  G4int first_event = 0;
+  for (auto i_process = 0; i_process < processes; ++i_process) {
+    auto share = events/processes + (i_process < events%processes ? 1 : 0);
+    auto pid = fork();
+    if (pid == 0) {
+      auto child_status = RunChild(i_process, first_event, share);
+      std::cout.flush();
+      std::cerr.flush();
+      _exit(child_status);
+    }
+    if (pid < 0) {
+      G4cerr << "ForkedJob: cannot fork process " << i_process << G4endl;
+      break;
+    }
+    children.push_back(pid);
+    first_event += share;
+  }
+
+  // wait for all children
+  G4bool ok = (G4int)children.size() == processes;
+  for (std::size_t i_process = 0; i_process < children.size(); ++i_process) {
+    int child_status = 0;
+    waitpid(children[i_process], &child_status, 0);
+    std::ostringstream suffix;
+    suffix << "_p" << i_process;
+    LiveHistograms::Remove(LiveHistograms::Instance()->GetName() + suffix.str());
+    if (!WIFEXITED(child_status) || WEXITSTATUS(child_status) != 0) {
+      G4cerr << "ForkedJob: process " << i_process << " failed, see " 
+             << file_ << "_p" << i_process << ".log" << G4endl;
+      ok = false;
+    }
+  }
+  if (!ok) return 1;
+
+  return Merge() ? 0 : 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ForkedJob::RunChild(G4int process, G4int first_event, G4int events) const
+{
+  std::ostringstream suffix;
+  suffix << "_p" << process;
+
+  // output of the child to its log file
+  auto log = open((file_ + suffix.str() + ".log").c_str(), 
+                  O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (log >= 0) {
+    dup2(log, 1);
+    dup2(log, 2);
+    close(log);
+  }
+
+  auto UImanager = G4UImanager::GetUIpointer();
+  UImanager->ApplyCommand("/analysis/setFileName " + file_ + suffix.str());
+  UImanager->ApplyCommand("/proton_pol/output/columnarFile " + columnar_file_ + suffix.str());
+  UImanager->ApplyCommand("/proton_pol/asymmetry/file");
+  UImanager->ApplyCommand("/proton_pol/live/name " 
+                          + LiveHistograms::Instance()->GetName() + suffix.str());
+  UImanager->ApplyCommand("/proton_pol/asymmetry/stateFile " 
+                          + file_ + suffix.str() + "_asymmetry.state");
+  if (!options_.GetTimingReport().empty()) {
+    UImanager->ApplyCommand("/proton_pol/run/timingReport " 
+                            + options_.GetTimingReport() + suffix.str());
+  }
+  UImanager->ApplyCommand("/proton_pol/run/eventOffset " 
+                          + G4UIcommand::ConvertToString(first_event));
+  auto status 
+    = UImanager->ApplyCommand("/run/beamOn " + G4UIcommand::ConvertToString(events));
+  return status == 0 ? 0 : 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ForkedJob::Merge() const
+{
+  std::vector<G4String> root_files, state_files, columnar_files;
+  for (auto i_process = 0; i_process < options_.GetProcesses(); ++i_process) {
+    std::ostringstream suffix;
+    suffix << "_p" << i_process;
+    root_files.push_back(file_ + suffix.str() + ".root");
+    state_files.push_back(file_ + suffix.str() + "_asymmetry.state");
+
+    // columnar files of the child (one per run)
+    glob_t files;
+    auto pattern = columnar_file_ + suffix.str() + "_run*_t*.ppcol";
+    if (glob(pattern.c_str(), 0, nullptr, &files) == 0) {
+      for (std::size_t i_file = 0; i_file < files.gl_pathc; ++i_file) {
+        columnar_files.push_back(files.gl_pathv[i_file]);
+      }
+    }
+    globfree(&files);
+  }
+
+  G4bool ok = MergeHistograms(file_ + ".root", root_files);
+  ok = RunMerge(file_ + "_asymmetry.state", state_files) && ok;
+  if (!asymmetry_file_.empty()) {
+    ok = RunMerge(asymmetry_file_, state_files, "-P " + polarization_) && ok;
+  }
+  if (!columnar_files.empty()) {
+    ok = RunMerge(columnar_file_ + "_merged.ppcol", columnar_files) && ok;
+  }
+  return ok;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ForkedJob::MergeHistograms(const G4String& output, 
+                                  const std::vector<G4String>& inputs) const
+{
+  // in this process, as Checkpoint: ROOT is not needed. The histograms of
+  // the parent are empty (/run/beamOn 0); the ntuples stay in the files
+  // of the children.
+  G4cout << "ForkedJob: merging the histograms of " << inputs.size() 
+         << " files into " << output << G4endl;
+  auto analysisManager = G4AnalysisManager::Instance();
+  auto reader = G4AnalysisReader::Instance();
+  for (const auto& input : inputs) {
+    for (auto i_h1 = 0; i_h1 < analysisManager->GetNofH1s(); ++i_h1) {
+      auto id = analysisManager->GetFirstH1Id() + i_h1;
+      auto h1 = reader->GetH1(reader->ReadH1(analysisManager->GetH1Name(id), input), false);
+      if (!h1) {
+        G4cerr << "ForkedJob: cannot read the histograms of " << input << G4endl;
+        return false;
+      }
+      analysisManager->GetH1(id)->add(*h1);
+    }
+    for (auto i_h2 = 0; i_h2 < analysisManager->GetNofH2s(); ++i_h2) {
+      auto id = analysisManager->GetFirstH2Id() + i_h2;
+      auto h2 = reader->GetH2(reader->ReadH2(analysisManager->GetH2Name(id), input), false);
+      if (!h2) {
+        G4cerr << "ForkedJob: cannot read the histograms of " << input << G4endl;
+        return false;
+      }
+      analysisManager->GetH2(id)->add(*h2);
+    }
+  }
+
+  auto ok = analysisManager->OpenFile(output);
+  ok = ok && analysisManager->Write();
+  ok = analysisManager->CloseFile() && ok;
+  if (!ok) G4cerr << "ForkedJob: cannot write " << output << G4endl;
+  return ok;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ForkedJob::RunMerge(const G4String& output, const std::vector<G4String>& inputs,
+                           const G4String& flags) const
+{
+  // the merge tool is installed next to this executable
+  auto slash = program_.rfind('/');
+  G4String directory = (slash == std::string::npos) ? "." : program_.substr(0, slash);
+
+  std::ostringstream command;
+  command << "\"" << directory << "/execute-proton_pol_merge\" " << flags
+          << " \"" << output << "\"";
+  for (const auto& input : inputs) command << " \"" << input << "\"";
+
+  G4cout << "ForkedJob: merging " << inputs.size() << " files into " << output << G4endl;
+  if (std::system(command.str().c_str()) != 0) {
+    G4cerr << "ForkedJob: merge into " << output << " failed" << G4endl;
+    return false;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,201 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file LiveHistogramReader.cc
+/// \brief Implementation of the LiveHistogramReader class
+
+#include "LiveHistogramReader.hh"
+
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// copies of a slot tried while its writer is busy
+const int kMaxAttempts = 1000;
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+LiveHistogramReader::LiveHistogramReader()
+: data_(nullptr), size_(0), generation_(0), events_(0),
+  nbins_(0), nslots_(0), slot_offset_(0), slot_size_(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+LiveHistogramReader::~LiveHistogramReader()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool LiveHistogramReader::Open(const std::string& name)
+{
+  Close();
+
+  auto segment = name.empty() || name[0] != '/' ? "/" + name : name;
+  auto fd = ::shm_open(segment.c_str(), O_RDONLY, 0);
+  if (fd < 0) return false;
+
+  struct stat status;
+  if (::fstat(fd, &status) != 0 || (std::size_t)status.st_size < sizeof(LiveHeader)) {
+    ::close(fd);
+    return false;
+  }
+  size_ = status.st_size;
+
+  auto mapping = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    size_ = 0;
+    return false;
+  }
+  data_ = static_cast<const unsigned char*>(mapping);
+
+  auto header = reinterpret_cast<const LiveHeader*>(data_);
+  if (std::memcmp(header->magic, kLiveMagic, sizeof(kLiveMagic)) != 0
+      || header->version != kLiveVersion) {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void LiveHistogramReader::Close()
+{
+  if (data_) ::munmap(const_cast<unsigned char*>(data_), size_);
+  data_ = nullptr;
+  size_ = 0;
+  generation_ = 0;
+  events_ = 0;
+  nbins_ = nslots_ = slot_offset_ = slot_size_ = 0;
+  infos_.clear();
+  entries_.clear();
+  bins_.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool LiveHistogramReader::Read()
+{
+  if (!data_) return false;
+
+  // generation 0 : layout being written, or segment removed by the job
+  auto header = reinterpret_cast<const LiveHeader*>(data_);
+  auto generation = header->generation.load(std::memory_order_acquire);
+  if (generation == 0) return false;
+
+  if (generation != generation_) {
+    // layout of a new run
+    auto nhistograms = header->nhistograms;
+    auto slots_end = header->slot_offset + header->nslots*header->slot_size;
+    if (sizeof(LiveHeader) + nhistograms*sizeof(LiveHistogramInfo) > header->slot_offset
+        || slots_end > size_
+        || sizeof(LiveSlotHeader) + (nhistograms + header->nbins)*sizeof(double) 
+             > header->slot_size) {
+      return false;
+    }
+    infos_.resize(nhistograms);
+    std::memcpy(infos_.data(), data_ + sizeof(LiveHeader), 
+                nhistograms*sizeof(LiveHistogramInfo));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header->generation.load(std::memory_order_relaxed) != generation) return false;
+    for (auto& info : infos_) info.name[kLiveNameLength-1] = '\0';
+    nbins_ = header->nbins;
+    nslots_ = header->nslots;
+    slot_offset_ = header->slot_offset;
+    slot_size_ = header->slot_size;
+    generation_ = generation;
+  }
+
+  // sum of the slots
+  auto nvalues = infos_.size() + nbins_;
+  std::vector<double> sums(nvalues, 0.), buffer(nvalues);
+  std::uint64_t events = 0;
+  for (std::size_t i_slot = 0; i_slot < nslots_; ++i_slot) {
+    std::uint64_t slot_events = 0;
+    if (!ReadSlot(i_slot, buffer, slot_events)) return false;
+    if (slot_events == 0) continue;
+    events += slot_events;
+    for (std::size_t i_value = 0; i_value < nvalues; ++i_value) sums[i_value] += buffer[i_value];
+  }
+  if (header->generation.load(std::memory_order_acquire) != generation) return false;
+
+  events_ = events;
+  entries_.assign(sums.begin(), sums.begin() + infos_.size());
+  bins_.assign(sums.begin() + infos_.size(), sums.end());
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool LiveHistogramReader::ReadSlot(std::size_t slot, std::vector<double>& buffer, 
+                                   std::uint64_t& events) const
+{
+  auto slot_data = data_ + slot_offset_ + slot*slot_size_;
+  auto slot_header = reinterpret_cast<const LiveSlotHeader*>(slot_data);
+
+  for (auto attempt = 0; attempt < kMaxAttempts; ++attempt) {
+    auto sequence = slot_header->sequence.load(std::memory_order_acquire);
+    if (sequence == 0) {
+      // never published
+      events = 0;
+      return true;
+    }
+    if (sequence & 1) {
+      std::this_thread::yield();
+      continue;
+    }
+    events = slot_header->events;
+    std::memcpy(buffer.data(), slot_data + sizeof(LiveSlotHeader), 
+                buffer.size()*sizeof(double));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot_header->sequence.load(std::memory_order_relaxed) == sequence) return true;
+  }
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int LiveHistogramReader::GetHistogramIndex(const std::string& name) const
+{
+  for (std::size_t i_histogram = 0; i_histogram < infos_.size(); ++i_histogram) {
+    if (name == infos_[i_histogram].name) return i_histogram;
+  }
+  return -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,313 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file LiveHistograms.cc
+/// \brief Implementation of the LiveHistograms class
+
+#include "LiveHistograms.hh"
+#include "Analysis.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4Run.hh"
+#include "G4RunManager.hh"
+#include "G4Threading.hh"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+LiveHistograms* LiveHistograms::fgInstance = nullptr;
+
+namespace {
+
+// histograms of the segment
+G4bool IsPublished(const G4String& name)
+{
+  const std::string suffix = "_hitposition_xy";
+  return name.compare(0, 9, "analysis_") == 0
+      || (name.size() > suffix.size() 
+          && name.compare(name.size()-suffix.size(), suffix.size(), suffix) == 0);
+}
+
+// POSIX shared memory object names start with a slash
+G4String SegmentName(const G4String& name)
+{
+  return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+LiveHistograms* LiveHistograms::Instance()
+{
+  // first called by the master RunAction, before the workers start
+  if (!fgInstance) fgInstance = new LiveHistograms;
+  return fgInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+LiveHistograms::LiveHistograms()
+: messenger_(nullptr), 
+  name_("/proton_pol_live"), events_(0),
+  data_(nullptr), size_(0), owner_(0), generation_(0)
+{
+  // define commands for this class
+  DefineCommands();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+LiveHistograms::~LiveHistograms()
+{
+  Unmap();
+  delete messenger_;
+  fgInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void LiveHistograms::Publish(const G4Run* run, G4bool end_of_run)
+{
+  if (!data_) return;
+  // the master of a multi-threaded run holds the merged histograms
+  if (G4Threading::IsMultithreadedApplication() && G4Threading::IsMasterThread()) return;
+
+  G4long events = run->GetNumberOfEvent();
+  if (!end_of_run && ++events % events_ != 0) return;  // this event is not yet recorded
+
+  auto header = reinterpret_cast<LiveHeader*>(data_);
+  std::size_t i_slot = G4Threading::G4GetThreadId() + 1;
+  if (i_slot >= header->nslots) return;
+
+  auto slot_data = data_ + header->slot_offset + i_slot*header->slot_size;
+  auto slot = reinterpret_cast<LiveSlotHeader*>(slot_data);
+  auto entries = reinterpret_cast<double*>(slot_data + sizeof(LiveSlotHeader));
+  auto bins = entries + histograms_.size();
+
+  // odd sequence while the slot is copied (only this thread writes it)
+  auto sequence = slot->sequence.load(std::memory_order_relaxed);
+  slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot->events = events;
+  auto analysisManager = G4AnalysisManager::Instance();
+  for (const auto& histogram : histograms_) {
+    if (histogram.dimension == 1) {
+      auto h1 = analysisManager->GetH1(histogram.id);
+      *entries++ = h1->entries();
+      for (unsigned int i_x = 0; i_x < h1->axis().bins(); ++i_x) {
+        *bins++ = h1->bin_height(i_x);
+      }
+    }
+    else {
+      auto h2 = analysisManager->GetH2(histogram.id);
+      *entries++ = h2->entries();
+      for (unsigned int i_x = 0; i_x < h2->axis_x().bins(); ++i_x) {
+        for (unsigned int i_y = 0; i_y < h2->axis_y().bins(); ++i_y) {
+          *bins++ = h2->bin_height(i_x, i_y);
+        }
+      }
+    }
+  }
+
+  slot->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void LiveHistograms::Start()
+{
+  histograms_.clear();
+  if (events_ <= 0) {
+    Unmap();
+    return;
+  }
+
+  // layout of the published histograms (the same on every thread)
+  auto analysisManager = G4AnalysisManager::Instance();
+  std::vector<LiveHistogramInfo> infos;
+  std::uint64_t nbins = 0;
+  auto AddInfo = [&](const G4String& name, G4int dimension, 
+                     const tools::histo::h1d::axis_t& x,
+                     const tools::histo::h1d::axis_t* y) {
+    LiveHistogramInfo info;
+    std::memset(&info, 0, sizeof(info));
+    std::strncpy(info.name, name.c_str(), kLiveNameLength - 1);
+    info.dimension = dimension;
+    info.nx = x.bins();
+    info.xmin = x.lower_edge();
+    info.xmax = x.upper_edge();
+    info.ny = y ? y->bins() : 1;
+    info.ymin = y ? y->lower_edge() : 0.;
+    info.ymax = y ? y->upper_edge() : 0.;
+    info.first_bin = nbins;
+    nbins += info.nx*info.ny;
+    infos.push_back(info);
+  };
+  for (auto i_h1 = 0; i_h1 < analysisManager->GetNofH1s(); ++i_h1) {
+    auto id = analysisManager->GetFirstH1Id() + i_h1;
+    auto name = analysisManager->GetH1Name(id);
+    if (!IsPublished(name)) continue;
+    AddInfo(name, 1, analysisManager->GetH1(id)->axis(), nullptr);
+    histograms_.push_back({ id, 1 });
+  }
+  for (auto i_h2 = 0; i_h2 < analysisManager->GetNofH2s(); ++i_h2) {
+    auto id = analysisManager->GetFirstH2Id() + i_h2;
+    auto name = analysisManager->GetH2Name(id);
+    if (!IsPublished(name)) continue;
+    auto h2 = analysisManager->GetH2(id);
+    AddInfo(name, 2, h2->axis_x(), &h2->axis_y());
+    histograms_.push_back({ id, 2 });
+  }
+
+  // one slot for the master (sequential mode) and one per worker
+  std::uint32_t nslots = G4RunManager::GetRunManager()->GetNumberOfThreads() + 1;
+  auto slot_offset = LiveAlign(sizeof(LiveHeader) + infos.size()*sizeof(LiveHistogramInfo));
+  auto slot_size = LiveAlign(sizeof(LiveSlotHeader) + (infos.size() + nbins)*sizeof(double));
+  if (!Map(slot_offset + nslots*slot_size)) {
+    histograms_.clear();
+    return;
+  }
+
+  // the layout is invalid (generation 0) while it is written
+  auto header = reinterpret_cast<LiveHeader*>(data_);
+  header->generation.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(header->magic, kLiveMagic, sizeof(kLiveMagic));
+  header->version = kLiveVersion;
+  header->nhistograms = infos.size();
+  header->nslots = nslots;
+  header->nbins = nbins;
+  header->slot_offset = slot_offset;
+  header->slot_size = slot_size;
+  std::memcpy(data_ + sizeof(LiveHeader), infos.data(), infos.size()*sizeof(LiveHistogramInfo));
+  std::memset(data_ + slot_offset, 0, nslots*slot_size);
+  header->generation.store(++generation_, std::memory_order_release);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void LiveHistograms::Remove(const G4String& name)
+{
+  auto segment = SegmentName(name);
+  auto fd = shm_open(segment.c_str(), O_RDWR, 0);
+  if (fd < 0) return;
+
+  // readers see a closed segment
+  auto mapping = mmap(nullptr, sizeof(LiveHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping != MAP_FAILED) {
+    static_cast<LiveHeader*>(mapping)->generation.store(0, std::memory_order_release);
+    munmap(mapping, sizeof(LiveHeader));
+  }
+  shm_unlink(segment.c_str());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool LiveHistograms::Map(std::size_t size)
+{
+  // the segment of the previous run is reused when the layout size is the same
+  auto segment = SegmentName(name_);
+  if (data_ && mapped_name_ == segment && size_ == size) return true;
+  Unmap();
+
+  // a new segment, readers of a segment left by another job keep their mapping
+  shm_unlink(segment.c_str());
+  auto fd = shm_open(segment.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd >= 0 && ftruncate(fd, size) == 0) {
+    auto mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping != MAP_FAILED) {
+      data_ = static_cast<unsigned char*>(mapping);
+      size_ = size;
+      mapped_name_ = segment;
+      owner_ = getpid();
+    }
+  }
+  if (fd >= 0) close(fd);
+
+  if (!data_) {
+    if (fd >= 0) shm_unlink(segment.c_str());
+    G4ExceptionDescription msg;
+    msg << "Cannot create the shared memory segment " << segment 
+        << " (" << size << " bytes), the live histograms are off." << G4endl;
+    G4Exception("LiveHistograms::Map()",
+                "Code001", JustWarning, msg);
+    return false;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void LiveHistograms::Unmap()
+{
+  if (!data_) return;
+
+  // a forked child does not remove the segment of its parent
+  if (owner_ == getpid()) {
+    reinterpret_cast<LiveHeader*>(data_)->generation.store(0, std::memory_order_release);
+    shm_unlink(mapped_name_.c_str());
+  }
+  munmap(data_, size_);
+  data_ = nullptr;
+  size_ = 0;
+  mapped_name_ = "";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void LiveHistograms::DefineCommands()
+{
+  // Define /proton_pol/live command directory using generic messenger class
+  messenger_ 
+    = new G4GenericMessenger(this, 
+        "/proton_pol/live/", 
+        "Live histograms in a shared memory segment");
+
+  // events command
+  auto& eventsCmd
+    = messenger_->DeclareProperty("events", events_, 
+        "Events between two copies published by each thread (0 : off).");
+  eventsCmd.SetParameterName("events", false);
+  eventsCmd.SetRange("events>=0");
+  eventsCmd.SetStates(G4State_PreInit, G4State_Idle);
+  eventsCmd.SetToBeBroadcasted(false);
+
+  // name command
+  auto& nameCmd
+    = messenger_->DeclareProperty("name", name_, 
+        "Name of the POSIX shared memory segment.");
+  nameCmd.SetParameterName("name", false);
+  nameCmd.SetStates(G4State_PreInit, G4State_Idle);
+  nameCmd.SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -29,6 +29,7 @@
 
 #include "PhysicsList.hh"
 #include "PhysicsListMessenger.hh"
+#include "StartupTimer.hh"
 
 #include "G4DecayPhysics.hh"
 #include "G4EmStandardPhysics.hh"
@@ -67,6 +68,15 @@
 #include "G4HadronPhysicsQGSP_FTFP_BERT.hh"
 #include "G4HadronPhysicsQGS_BIC.hh"
 #include "G4RadioactiveDecayPhysics.hh"
+#include "G4GenericBiasingPhysics.hh"
+
+#include "G4RegionStore.hh"
+#include "G4Region.hh"
+#include "G4ProductionCuts.hh"
+#include "G4Threading.hh"
+#include "G4Material.hh"
+#include "G4Element.hh"
+#include "G4Version.hh"
 
 #include "G4ProcessManager.hh"
 #include "G4ParticleTypes.hh"
@@ -77,10 +87,42 @@
 #include "G4Proton.hh"
 
 #include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// removes a directory of physics table files (no subdirectories)
+void RemoveTableDirectory(const G4String& directory)
+{
+  if(auto dir = opendir(directory.c_str())) {
+    std::vector<G4String> names;
+    while(auto entry = readdir(dir)) {
+      G4String name = entry->d_name;
+      if(name != "." && name != "..") names.push_back(name);
+    }
+    closedir(dir);
+    for(const auto& name : names) unlink((directory + "/" + name).c_str());
+  }
+  rmdir(directory.c_str());
+}
+
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo.....
 
-PhysicsList::PhysicsList() : G4VModularPhysicsList()
+PhysicsList::PhysicsList() 
+: G4VModularPhysicsList(), fBiasingPhys(0), fCacheStorePending(false)
 {
   SetDefaultCutValue(0.7*CLHEP::mm);
 
@@ -94,6 +136,10 @@ PhysicsList::PhysicsList() : G4VModularPhysicsList()
 
   // EM physics
   fEmPhysicsList = new G4EmStandardPhysics(verboseLevel);
+
+  // physics table cache (or /proton_pol/PhysicsTableCache)
+  char* cache = std::getenv("PROTON_POL_PHYSICS_CACHE");
+  if(cache) SetPhysicsTableCache(cache);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo.....
@@ -106,6 +152,7 @@ PhysicsList::~PhysicsList()
   for(size_t i=0; i<fHadronPhys.size(); i++) {
     delete fHadronPhys[i];
   }
+  delete fBiasingPhys;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo.....
@@ -119,18 +166,247 @@ void PhysicsList::ConstructParticle()
 
 void PhysicsList::ConstructProcess()
 {
+  StartupTimer::Scope timer("ConstructProcess");
+
   AddTransportation();
   fEmPhysicsList->ConstructProcess();
   fParticleList->ConstructProcess();
   for(size_t i=0; i<fHadronPhys.size(); i++) {
     fHadronPhys[i]->ConstructProcess();
   }
+  // biasing wraps processes constructed above, so it comes last
+  if(fBiasingPhys) {
+    fBiasingPhys->ConstructProcess();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo.....
+
+void PhysicsList::SetCuts()
+{
+  // default cut (World region)
+  G4VUserPhysicsList::SetCuts();
+
+  // regions are shared by the threads: set their cuts once on master
+  if(G4Threading::IsWorkerThread()) return;
+
+  for(const auto& regionCut : fRegionCuts) {
+    auto region 
+      = G4RegionStore::GetInstance()->GetRegion(regionCut.first, false);
+    if(!region) {
+      G4ExceptionDescription msg;
+      msg << "Region " << regionCut.first << " is not defined, "
+          << "production cut is not set." << G4endl;
+      G4Exception("PhysicsList::SetCuts()",
+                  "Code001", JustWarning, msg);
+      continue;
+    }
+    auto cuts = region->GetProductionCuts();
+    if(!cuts) {
+      cuts = new G4ProductionCuts();
+      region->SetProductionCuts(cuts);
+    }
+    cuts->SetProductionCut(regionCut.second);
+    if (verboseLevel>0) {
+      G4cout << "PhysicsList::SetCuts: region <" << regionCut.first 
+             << "> cut " << G4BestUnit(regionCut.second, "Length") << G4endl;
+    }
+  }
+
+  // geometry, materials and cuts are known now
+  if(!fCacheDirectory.empty()) SetUpPhysicsTableCache();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo.....
+
+void PhysicsList::SetPhysicsTableCache(const G4String& directory)
+{
+  fCacheDirectory = (directory == "none") ? G4String() : directory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo.....
+
+G4String PhysicsList::GetPhysicsConfiguration() const
+{
+  // everything the physics tables depend on, in a fixed order
+  std::ostringstream config;
+  config << std::setprecision(10);
+  config << "geant4 " << G4VERSION_NUMBER << "\n";
+  config << "physics";
+  for(const auto& name : fPhysicsNames) config << " " << name;
+  config << "\n";
+  for(const auto& regionEm : fRegionEm) {
+    config << "em " << regionEm.first << " " << regionEm.second << "\n";
+  }
+  config << "biasing " << (fBiasingPhys ? 1 : 0) << "\n";
+  config << "cut World " << GetDefaultCutValue()/mm << "\n";
+  for(const auto& regionCut : fRegionCuts) {
+    config << "cut " << regionCut.first << " " << regionCut.second/mm << "\n";
+  }
+  for(const auto material : *G4Material::GetMaterialTable()) {
+    config << "material " << material->GetName() 
+           << " " << material->GetDensity()/(g/cm3);
+    auto fractions = material->GetFractionVector();
+    for(size_t i=0; i<material->GetNumberOfElements(); ++i) {
+      config << " " << material->GetElement(i)->GetName() 
+             << ":" << fractions[i];
+    }
+    config << "\n";
+  }
+  return config.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo.....
+
+void PhysicsList::SetUpPhysicsTableCache()
+{
+  // cache entry named by the FNV-1a hash of the configuration
+  auto config = GetPhysicsConfiguration();
+  uint64_t hash = 14695981039346656037ULL;
+  for(auto c : config) {
+    hash ^= (unsigned char)c;
+    hash *= 1099511628211ULL;
+  }
+  std::ostringstream entry;
+  entry << fCacheDirectory << "/" << std::hex << std::setw(16) 
+        << std::setfill('0') << hash;
+  fCacheEntry = entry.str();
+
+  // the key file is written last: an entry is valid only when it is 
+  // present and identical to the configuration (no hash collision)
+  std::ifstream keyFile(fCacheEntry + "/physics.key");
+  std::stringstream key;
+  key << keyFile.rdbuf();
+  if(keyFile && key.str() == config) {
+    // retrieval falls back to building the tables which cannot be read
+    SetPhysicsTableRetrieved(fCacheEntry);
+    fCacheStorePending = false;
+    G4cout << "PhysicsList: physics tables are retrieved from "
+           << fCacheEntry << G4endl;
+  } else {
+    ResetPhysicsTableRetrieved();
+    fCacheStorePending = true;
+    G4cout << "PhysicsList: physics tables will be stored in "
+           << fCacheEntry << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo.....
+
+void PhysicsList::StorePhysicsTableCache()
+{
+  if(!fCacheStorePending) return;
+  fCacheStorePending = false;
+
+  // the tables are stored in a private directory which is renamed to
+  // the entry when complete: jobs sharing the cache never see a partial
+  // entry, and the first job to finish wins
+  mkdir(fCacheDirectory.c_str(), 0755);
+  std::vector<char> name(fCacheEntry.begin(), fCacheEntry.end());
+  const char suffix[] = ".tmp.XXXXXX";
+  name.insert(name.end(), suffix, suffix + sizeof(suffix));
+  if(!mkdtemp(name.data())) {
+    G4ExceptionDescription msg;
+    msg << "Cannot create a directory in " << fCacheDirectory << G4endl;
+    G4Exception("PhysicsList::StorePhysicsTableCache()",
+                "Code001", JustWarning, msg);
+    return;
+  }
+  G4String temporary = name.data();
+
+  if(!StorePhysicsTable(temporary)) {
+    G4ExceptionDescription msg;
+    msg << "Cannot store physics tables in " << temporary << G4endl;
+    G4Exception("PhysicsList::StorePhysicsTableCache()",
+                "Code001", JustWarning, msg);
+    RemoveTableDirectory(temporary);
+    return;
+  }
+  {
+    std::ofstream keyFile(temporary + "/physics.key");
+    keyFile << GetPhysicsConfiguration();
+  }
+
+  // fails when another job has stored the entry meanwhile: keep that one
+  if(std::rename(temporary.c_str(), fCacheEntry.c_str()) != 0) {
+    G4cout << "PhysicsList: physics tables already stored in "
+           << fCacheEntry << G4endl;
+    RemoveTableDirectory(temporary);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo.....
+
+void PhysicsList::SetRegionCut(const G4String& region, G4double cut)
+{
+  if(region == "World") {
+    SetDefaultCutValue(cut);
+  } else {
+    fRegionCuts[region] = cut;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo.....
+
+void PhysicsList::SetRegionEmOption(const G4String& region, const G4String& name)
+{
+  // the World region uses the global EM constructor
+  if(region == "World") {
+    AddPhysicsList(name);
+    return;
+  }
+
+  // other regions: models of the option are activated on top of the
+  // global EM constructor by G4EmModelActivator
+  G4String type;
+  if (name == "emstandard_opt0")      { type = "G4EmStandard"; }
+  else if (name == "emstandard_opt1") { type = "G4EmStandard_opt1"; }
+  else if (name == "emstandard_opt2") { type = "G4EmStandard_opt2"; }
+  else if (name == "emstandard_opt3") { type = "G4EmStandard_opt3"; }
+  else if (name == "emstandard_opt4") { type = "G4EmStandard_opt4"; }
+  else if (name == "emstandardGS")    { type = "G4EmStandardGS"; }
+  else if (name == "emlivermore")     { type = "G4EmLivermore"; }
+  else if (name == "empenelope")      { type = "G4EmPenelope"; }
+  else {
+    G4cout << "PhysicsList::SetRegionEmOption: <" << name << ">"
+           << " is not defined" << G4endl;
+    return;
+  }
+  G4EmParameters::Instance()->AddPhysics(region, type);
+  fRegionEm[region] = type;
+
+  if (verboseLevel>0) {
+    G4cout << "PhysicsList::SetRegionEmOption: region <" << region 
+           << "> uses " << type << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo.....
+
+void PhysicsList::SetBiasing(G4bool flag)
+{
+  delete fBiasingPhys;
+  fBiasingPhys = 0;
+  if(!flag) return;
+
+  // occurrence biasing of the proton hadronic interactions,
+  // driven by TargetBiasingOperator in the target volume
+  auto biasingPhysics = new G4GenericBiasingPhysics();
+  std::vector<G4String> processes = { "hadElastic", "protonInelastic" };
+  biasingPhysics->PhysicsBias("proton", processes);
+  fBiasingPhys = biasingPhysics;
+
+  if (verboseLevel>0) {
+    G4cout << "PhysicsList::SetBiasing: proton hadElastic and protonInelastic"
+           << " are biased" << G4endl;
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo.....
 
 void PhysicsList::AddPhysicsList(const G4String& name)
 {
+  fPhysicsNames.push_back(name);
   if (verboseLevel>0) {
     G4cout << "PhysicsList::AddPhysicsList: <" << name << ">" << G4endl;
   }
@@ -164,6 +440,16 @@ void PhysicsList::AddPhysicsList(const G4String& name)
     delete fEmPhysicsList;
     fEmPhysicsList = new G4EmStandardPhysicsGS(verboseLevel);
 
+  } else if (name == "emlivermore") {
+
+    delete fEmPhysicsList;
+    fEmPhysicsList = new G4EmLivermorePhysics(verboseLevel);
+
+  } else if (name == "empenelope") {
+
+    delete fEmPhysicsList;
+    fEmPhysicsList = new G4EmPenelopePhysics(verboseLevel);
+
   } else if (name == "FTFP_BERT_EMV") {
 
     AddPhysicsList("FTFP_BERT");
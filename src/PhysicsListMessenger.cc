@@ -33,6 +33,11 @@
 #include "PhysicsList.hh"
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -47,6 +52,45 @@ PhysicsListMessenger::PhysicsListMessenger(PhysicsList* pPhys)
   fListCmd = new G4UIcmdWithoutParameter("/proton_pol/ListPhysics",this);
   fListCmd->SetGuidance("Available Physics Lists");
   fListCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fBiasingCmd = new G4UIcmdWithABool("/proton_pol/Biasing",this);
+  fBiasingCmd->SetGuidance("Occurrence biasing of the proton hadronic interactions");
+  fBiasingCmd->SetGuidance("in the target (factor: /proton_pol/detector/biasingFactor).");
+  fBiasingCmd->SetParameterName("flag",true);
+  fBiasingCmd->SetDefaultValue(true);
+  fBiasingCmd->AvailableForStates(G4State_PreInit);
+
+  fRegionCutCmd = new G4UIcommand("/proton_pol/RegionCut",this);
+  fRegionCutCmd->SetGuidance("Set the production cut of a region.");
+  fRegionCutCmd->SetGuidance("World sets the default cut.");
+  auto regionPrm = new G4UIparameter("region",'s',false);
+  regionPrm->SetParameterCandidates("World Target DriftChambers");
+  fRegionCutCmd->SetParameter(regionPrm);
+  auto cutPrm = new G4UIparameter("cut",'d',false);
+  cutPrm->SetParameterRange("cut>0.");
+  fRegionCutCmd->SetParameter(cutPrm);
+  auto unitPrm = new G4UIparameter("unit",'s',true);
+  unitPrm->SetDefaultValue("mm");
+  fRegionCutCmd->SetParameter(unitPrm);
+  fRegionCutCmd->AvailableForStates(G4State_PreInit);
+
+  fRegionEmCmd = new G4UIcommand("/proton_pol/RegionEm",this);
+  fRegionEmCmd->SetGuidance("Set the EM option of a region.");
+  fRegionEmCmd->SetGuidance("World replaces the global EM constructor.");
+  regionPrm = new G4UIparameter("region",'s',false);
+  regionPrm->SetParameterCandidates("World Target DriftChambers");
+  fRegionEmCmd->SetParameter(regionPrm);
+  auto emPrm = new G4UIparameter("option",'s',false);
+  emPrm->SetParameterCandidates("emstandard_opt0 emstandard_opt1 emstandard_opt2 "
+    "emstandard_opt3 emstandard_opt4 emstandardGS emlivermore empenelope");
+  fRegionEmCmd->SetParameter(emPrm);
+  fRegionEmCmd->AvailableForStates(G4State_PreInit);
+
+  fCacheCmd = new G4UIcmdWithAString("/proton_pol/PhysicsTableCache",this);
+  fCacheCmd->SetGuidance("Store and retrieve the physics tables in a cache directory,");
+  fCacheCmd->SetGuidance("one entry per physics configuration (none : no cache).");
+  fCacheCmd->SetParameterName("directory",false);
+  fCacheCmd->AvailableForStates(G4State_PreInit);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -55,6 +99,10 @@ PhysicsListMessenger::~PhysicsListMessenger()
 {
   delete fPListCmd;
   delete fListCmd;
+  delete fBiasingCmd;
+  delete fRegionCutCmd;
+  delete fRegionEmCmd;
+  delete fCacheCmd;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -81,6 +129,33 @@ void PhysicsListMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
              << "for reference Physics List" << G4endl;
     }
 
+  } else if( command == fBiasingCmd ) {
+    if(fPhysicsList) {
+      fPhysicsList->SetBiasing(fBiasingCmd->GetNewBoolValue(newValue));
+    }
+
+  } else if( command == fRegionCutCmd ) {
+    if(fPhysicsList) {
+      G4String region, unit;
+      G4double cut;
+      std::istringstream is(newValue);
+      is >> region >> cut >> unit;
+      fPhysicsList->SetRegionCut(region, cut*G4UIcommand::ValueOf(unit));
+    }
+
+  } else if( command == fRegionEmCmd ) {
+    if(fPhysicsList) {
+      G4String region, name;
+      std::istringstream is(newValue);
+      is >> region >> name;
+      fPhysicsList->SetRegionEmOption(region, name);
+    }
+
+  } else if( command == fCacheCmd ) {
+    if(fPhysicsList) {
+      fPhysicsList->SetPhysicsTableCache(newValue);
+    }
+
   } else if( command == fListCmd ) {
     if(fPhysicsList) {
       fPhysicsList->List();
@@ -28,19 +28,23 @@
 /// \brief Implementation of the PrimaryGeneratorAction class
 
 #include "PrimaryGeneratorAction.hh"
+#include "RunAction.hh"
+#include "EventAction.hh"
 
 #include "G4Event.hh"
 #include "G4ParticleGun.hh"
 #include "G4ParticleTable.hh"
 #include "G4ParticleDefinition.hh"
 #include "G4GenericMessenger.hh"
+#include "G4RunManager.hh"
 #include "G4SystemOfUnits.hh"
 #include "Randomize.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-PrimaryGeneratorAction::PrimaryGeneratorAction()
+PrimaryGeneratorAction::PrimaryGeneratorAction(EventAction* event_action)
 : G4VUserPrimaryGeneratorAction(),     
+  event_action_(event_action),
   particlegun_(nullptr), messenger_(nullptr), 
   proton_(nullptr),
   momentum_(200.*MeV),
@@ -72,6 +76,14 @@ PrimaryGeneratorAction::~PrimaryGeneratorAction()
 
 void PrimaryGeneratorAction::GeneratePrimaries(G4Event* event)
 {
+  // the event is busy from the primary generation on
+  event_action_->StartEventTimer();
+
+  // first use of random numbers in the event: reseed (event seeding)
+  auto runAction = static_cast<const RunAction*>(
+      G4RunManager::GetRunManager()->GetUserRunAction());
+  if (runAction) runAction->SeedEvent(event->GetEventID());
+
   G4ParticleDefinition* particle = proton_;  
   particlegun_->SetParticleDefinition(proton_);
 
@@ -0,0 +1,78 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file Run.cc
+/// \brief Implementation of the Run class
+
+#include "Run.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Run::Run(G4int theta_bins, G4double theta_min, G4double theta_max)
+: G4Run(),
+  busy_time_(0.),
+  dc_charged_steps_(0), dc_hits_(0),
+  killed_tracks_{},
+  weighted_events_(0), sum_weights_(0.), sum_weights2_(0.),
+  asymmetry_(theta_bins, theta_min, theta_max)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Run::~Run()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::Merge(const G4Run* run)
+{
+  auto local_run = static_cast<const Run*>(run);
+
+  busy_time_ += local_run->busy_time_;
+  worker_busy_times_.push_back(local_run->busy_time_);
+  worker_events_.push_back(local_run->GetNumberOfEvent());
+
+  dc_charged_steps_ += local_run->dc_charged_steps_;
+  dc_hits_ += local_run->dc_hits_;
+  for (auto i_rule = 0; i_rule < kTotalStackingRules; ++i_rule) {
+    killed_tracks_[i_rule] += local_run->killed_tracks_[i_rule];
+  }
+  if (cutflow_.size() < local_run->cutflow_.size()) {
+    cutflow_.resize(local_run->cutflow_.size(), 0);
+  }
+  for (std::size_t i_stage = 0; i_stage < local_run->cutflow_.size(); ++i_stage) {
+    cutflow_[i_stage] += local_run->cutflow_[i_stage];
+  }
+  weighted_events_ += local_run->weighted_events_;
+  sum_weights_ += local_run->sum_weights_;
+  sum_weights2_ += local_run->sum_weights2_;
+  asymmetry_.Merge(local_run->asymmetry_);
+  stepping_profile_.Merge(local_run->stepping_profile_);
+
+  G4Run::Merge(run);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -28,19 +28,86 @@
 /// \brief Implementation of the RunAction class
 
 #include "RunAction.hh"
+#include "Run.hh"
+#include "EventOutput.hh"
+#include "EventSkim.hh"
+#include "AsyncEventWriter.hh"
+#include "Telemetry.hh"
+#include "Snapshot.hh"
+#include "LiveHistograms.hh"
+#include "Checkpoint.hh"
+#include "Constants.hh"
 #include "Analysis.hh"
+#include "PhysicsList.hh"
 
 #include "time.h"
 
 #include "G4Run.hh"
 #include "G4RunManager.hh"
+#include "G4RunManagerKernel.hh"
+#include "G4GenericMessenger.hh"
+#include "G4UImanager.hh"
+#include "Randomize.hh"
+#include "G4Threading.hh"
 #include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
 
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <string>
+
+namespace {
+
+// SplitMix64 finalizer: a counter-based generator of independent 64 bit
+// values (one per counter value)
+uint64_t Mix(uint64_t z)
+{
+  z += 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// peak resident memory of the process [MB] (0 if unknown)
+G4double GetPeakResidentMemory()
+{
+  std::ifstream status("/proc/self/status");
+  std::string key;
+  while (status >> key) {
+    if (key == "VmHWM:") {
+      G4double kilobytes = 0.;
+      status >> kilobytes;
+      return kilobytes/1024.;
+    }
+    status.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+  }
+  return 0.;
+}
+
+}
+
+G4long RunAction::fgEventSeedingRunSeed = 0;
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 RunAction::RunAction()
- : G4UserRunAction()
+ : G4UserRunAction(),
+   messenger_(nullptr),
+   asymmetry_messenger_(nullptr),
+   random_seed_(0),
+   event_seeding_(false),
+   replay_event_(-1),
+   event_offset_(0),
+   timing_report_(""),
+   theta_bins_(20),
+   theta_min_(5.*deg),
+   theta_max_(25.*deg),
+   beam_polarization_(1.),
+   asymmetry_file_("proton_pol_asymmetry.csv"),
+   asymmetry_state_file_("")
 { 
   auto analysisManager = G4AnalysisManager::Instance();
   G4cout << "Using " << analysisManager->GetType() << G4endl;
@@ -101,27 +168,97 @@ RunAction::RunAction()
   analysisManager->CreateNtupleFColumn("dcout_momentum_y"); // column Id =12
   analysisManager->CreateNtupleFColumn("dcout_momentum_z"); // column Id =13
 
+  analysisManager->CreateNtupleFColumn("weight");           // column Id =14
+
   analysisManager->FinishNtuple();
+
+  // Event output of this thread (defines the /proton_pol/output/ commands)
+  EventOutput::Instance();
+
+  // Event skim of this thread (defines the /proton_pol/skim/ commands)
+  EventSkim::Instance();
+
+  // Telemetry of the process, created on master before the workers start
+  // (defines the /proton_pol/telemetry/ commands)
+  if (G4Threading::IsMasterThread()) Telemetry::Instance();
+
+  // Writer thread of the asynchronous event output, created on master
+  if (G4Threading::IsMasterThread()) AsyncEventWriter::Instance();
+
+  // In-flight snapshots, created on master (defines the /proton_pol/snapshot/ commands)
+  if (G4Threading::IsMasterThread()) Snapshot::Instance();
+
+  // Live histograms, created on master (defines the /proton_pol/live/ commands)
+  if (G4Threading::IsMasterThread()) LiveHistograms::Instance();
+
+  // define commands for this class
+  DefineCommands();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 RunAction::~RunAction()
 {
+  delete messenger_;
+  delete asymmetry_messenger_;
+  delete EventOutput::Instance();
+  delete EventSkim::Instance();
+  if (IsMaster()) delete Telemetry::Instance();
+  if (IsMaster()) delete AsyncEventWriter::Instance();
+  if (IsMaster()) delete Snapshot::Instance();
+  if (IsMaster()) delete LiveHistograms::Instance();
   delete G4AnalysisManager::Instance();  
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void RunAction::BeginOfRunAction(const G4Run* /*run*/)
+G4Run* RunAction::GenerateRun()
+{
+  return new Run(theta_bins_, theta_min_/deg, theta_max_/deg);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::BeginOfRunAction(const G4Run* run)
 { 
-  G4long random_seed  = time(NULL);
-  G4int random_luxury = 5;
-  CLHEP::HepRandom::setTheSeed(random_seed,random_luxury);
+  run_start_ = std::chrono::steady_clock::now();
+
+  G4long random_seed  = random_seed_ ? random_seed_ : time(NULL);
+  if (event_seeding_) {
+    // every event is seeded in SeedEvent(): no engine state files
+    G4RunManager::GetRunManager()->SetRandomNumberStore(false);
+    if (IsMaster()) {
+      fgEventSeedingRunSeed = random_seed;
+      G4cout << "### Event seeding, run seed " << random_seed;
+      if (replay_event_ >= 0) G4cout << ", replaying event " << replay_event_;
+      G4cout << G4endl;
+    }
+    if (replay_event_ >= 0) {
+      G4UImanager::GetUIpointer()->ApplyCommand("/tracking/verbose 2");
+    }
+  } 
+  else {
+    G4int random_luxury = 5;
+    CLHEP::HepRandom::setTheSeed(random_seed,random_luxury);
+
+    //inform the runManager to save random number seed
+    G4RunManager::GetRunManager()->SetRandomNumberStore(true);
+    G4RunManager::GetRunManager()->SetRandomNumberStoreDir("./rndm/");
+  }
 
-  //inform the runManager to save random number seed
-  G4RunManager::GetRunManager()->SetRandomNumberStore(true);
-  G4RunManager::GetRunManager()->SetRandomNumberStoreDir("./rndm/");
+  // Store the physics tables built at the first run (cache miss)
+  if (IsMaster()) {
+    auto physicsList = dynamic_cast<PhysicsList*>(
+        G4RunManagerKernel::GetRunManagerKernel()->GetPhysicsList());
+    if (physicsList) physicsList->StorePhysicsTableCache();
+  }
+
+  // Live telemetry, in-flight snapshots and live histograms of the event loop
+  if (IsMaster()) {
+    Telemetry::Instance()->Start(run->GetNumberOfEventToBeProcessed());
+    Snapshot::Instance()->Start(beam_polarization_);
+    LiveHistograms::Instance()->Start();
+  }
 
   // Get analysis manager
   auto analysisManager = G4AnalysisManager::Instance();
@@ -130,18 +267,295 @@ void RunAction::BeginOfRunAction(const G4Run* /*run*/)
   // The default file name is set in RunAction::RunAction(),
   // it can be overwritten in a macro
   analysisManager->OpenFile();
+
+  // Selection of the written events, on every thread (stage names on master)
+  EventSkim::Instance()->Compile();
+
+  // Open the native event output on the threads which process events
+  if (!IsMaster() || !G4Threading::IsMultithreadedApplication()) {
+    EventOutput::Instance()->OpenRun(run->GetRunID());
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void RunAction::EndOfRunAction(const G4Run* /*run*/)
+void RunAction::EndOfRunAction(const G4Run* run)
 {
+  // totals of the previous segments of a checkpointed job (master)
+  auto checkpoint = Checkpoint::GetInstance();
+  if (checkpoint && IsMaster()) {
+    checkpoint->Accumulate(
+      static_cast<Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun()));
+  }
+
+  // last copy of the live histograms, before the worker histograms are merged
+  LiveHistograms::Instance()->Publish(run, true);
+
   // save histograms & ntuple
   //
   auto analysisManager = G4AnalysisManager::Instance();
   analysisManager->Write();
   analysisManager->CloseFile();
 
+  EventOutput::Instance()->CloseRun();
+
+  // run summary (on master, after the worker runs are merged)
+  //
+  if (!IsMaster()) return;
+
+  Telemetry::Instance()->Stop();
+  Snapshot::Instance()->Stop();
+
+  std::chrono::duration<G4double> wall_time
+    = std::chrono::steady_clock::now() - run_start_;
+  PrintRunSummary(run, wall_time.count());
+  PrintCutflow(run);
+  auto& profile = static_cast<const Run*>(run)->GetSteppingProfile();
+  if (!profile.IsEmpty()) profile.Print(G4cout, 25);
+  if (!timing_report_.empty()) WriteTimingReport(run, wall_time.count());
+  PrintAsymmetry(run);
+  if (checkpoint) checkpoint->Commit();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::PrintCutflow(const G4Run* run) const
+{
+  auto names = EventSkim::Instance()->GetStageNames();
+  auto local_run = static_cast<const Run*>(run);
+  auto all_events = local_run->GetCutflow(0);
+  if (names.size() < 2 || all_events == 0) return;
+
+  G4cout << G4endl
+         << "------------------------- Skim cutflow ------------------------" << G4endl;
+  auto precision = G4cout.precision(4);
+  auto previous = all_events;
+  for (std::size_t i_stage = 0; i_stage < names.size(); ++i_stage) {
+    auto events = local_run->GetCutflow(i_stage);
+    G4cout << " " << std::left << std::setw(30) << names[i_stage] << std::right
+           << std::setw(12) << events
+           << std::setw(10) << 100.*events/all_events << " %"
+           << std::setw(10) << (previous ? 100.*events/previous : 0.) << " %" 
+           << G4endl;
+    previous = events;
+  }
+  G4cout.precision(precision);
+  G4cout << " written events : " << local_run->GetCutflow(names.size()-1) << G4endl
+         << "--------------------------------------------------------------" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::PrintAsymmetry(const G4Run* run) const
+{
+  const auto& asymmetry = static_cast<const Run*>(run)->GetAsymmetry();
+  if (asymmetry.GetEvents() <= 0.) return;
+
+  G4cout << G4endl
+         << "------------------------- Asymmetry ---------------------------" << G4endl;
+  asymmetry.Print(G4cout, beam_polarization_, kAnalysisThetaMin, kAnalysisThetaMax);
+  G4cout << "--------------------------------------------------------------" << G4endl;
+
+  if (!asymmetry_file_.empty() 
+      && !asymmetry.Write(asymmetry_file_, beam_polarization_)) {
+    G4ExceptionDescription msg;
+    msg << "Cannot write asymmetry file " << asymmetry_file_ << G4endl;
+    G4Exception("RunAction::PrintAsymmetry()",
+                "Code001", JustWarning, msg);
+  }
+
+  if (!asymmetry_state_file_.empty() && !asymmetry.Save(asymmetry_state_file_)) {
+    G4ExceptionDescription msg;
+    msg << "Cannot write asymmetry state file " << asymmetry_state_file_ << G4endl;
+    G4Exception("RunAction::PrintAsymmetry()",
+                "Code001", JustWarning, msg);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::PrintRunSummary(const G4Run* run, G4double wall_time) const
+{
+  auto local_run = static_cast<const Run*>(run);
+  auto nevents = run->GetNumberOfEvent();
+  if (nevents == 0 || wall_time <= 0.) return;
+
+  G4cout << G4endl
+         << "------------------------- Run summary -------------------------" << G4endl
+         << " events : " << nevents << G4endl
+         << " wall   : " << wall_time << " s" << G4endl
+         << " rate   : " << nevents/wall_time << " events/s" << G4endl;
+
+  const auto& busy_times = local_run->GetWorkerBusyTimes();
+  const auto& events = local_run->GetWorkerEvents();
+  for (std::size_t i_thread = 0; i_thread < busy_times.size(); ++i_thread) {
+    auto idle_time = std::max(0., wall_time - busy_times[i_thread]);
+    G4cout << " worker " << i_thread 
+           << " : events " << events[i_thread]
+           << ", busy " << busy_times[i_thread] << " s"
+           << ", idle " << idle_time << " s"
+           << " (" << 100.*idle_time/wall_time << " %)" << G4endl;
+  }
+
+  // drift chamber hits (charged steps = hits of the kRecordAllSteps policy)
+  G4cout << " drift chambers : " 
+         << (G4double)local_run->GetDriftChamberChargedSteps()/nevents
+         << " charged steps/event, "
+         << (G4double)local_run->GetDriftChamberHits()/nevents
+         << " hits recorded/event" << G4endl;
+
+  // tracks killed by the stacking action
+  G4cout << " killed tracks : "
+         << local_run->GetKilledTracks(kKillNeutral) << " neutral, "
+         << local_run->GetKilledTracks(kKillLowEnergy) << " low energy, "
+         << local_run->GetKilledTracks(kKillAcceptance) << " outside acceptance, "
+         << local_run->GetKilledTracks(kKillLateTime) << " late" << G4endl;
+
+  // event weights (different from 1 with biasing)
+  if (local_run->GetWeightedEvents() > 0) {
+    auto sum_weights = local_run->GetSumOfWeights();
+    G4cout << " DCOUT events  : " << local_run->GetWeightedEvents()
+           << ", sum of weights " << sum_weights
+           << ", effective entries " 
+           << sum_weights*sum_weights/local_run->GetSumOfWeights2() << G4endl;
+  }
+  G4cout << "--------------------------------------------------------------" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::WriteTimingReport(const G4Run* run, G4double wall_time) const
+{
+  // plain "key values..." lines, read back by the --scaling driver
+  auto local_run = static_cast<const Run*>(run);
+  std::ofstream report(timing_report_);
+  if (!report) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open timing report " << timing_report_ << G4endl;
+    G4Exception("RunAction::WriteTimingReport()",
+                "Code001", JustWarning, msg);
+    return;
+  }
+
+  auto busy_times = local_run->GetWorkerBusyTimes();
+  if (busy_times.empty()) busy_times.push_back(local_run->GetBusyTime());
+
+  report << "events " << run->GetNumberOfEvent() << "\n";
+  report << "threads " << busy_times.size() << "\n";
+  report << "wall " << wall_time << "\n";
+  report << "busy";
+  for (auto busy_time : busy_times) report << " " << busy_time;
+  report << "\n";
+  report << "peak_rss_mb " << GetPeakResidentMemory() << "\n";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::SeedEvent(G4int event_id) const
+{
+  if (!event_seeding_) return;
+  event_id += event_offset_;
+  if (replay_event_ >= 0) event_id = replay_event_;
+
+  // engine seeds from the counter-based hash of (run seed, event ID);
+  // the list is zero terminated and the seeds are positive
+  auto key = Mix((uint64_t)fgEventSeedingRunSeed ^ Mix((uint64_t)event_id));
+  long seeds[5] = { 0, 0, 0, 0, 0 };
+  for (auto i_seed = 0; i_seed < 4; ++i_seed) {
+    seeds[i_seed] = (long)(Mix(key + i_seed) >> 33) + 1;
+  }
+  G4Random::setTheSeeds(seeds);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::DefineCommands()
+{
+  // Define /proton_pol/run command directory using generic messenger class
+  messenger_ 
+    = new G4GenericMessenger(this, 
+        "/proton_pol/run/", 
+        "Run control");
+
+  // seed command
+  auto& seedCmd
+    = messenger_->DeclareProperty("seed", random_seed_, 
+        "Random seed of the run (0 : seed from the current time).");
+  seedCmd.SetParameterName("seed", true);
+  seedCmd.SetRange("seed>=0");
+  seedCmd.SetDefaultValue("0");
+
+  // eventSeeding command
+  auto& eventSeedingCmd
+    = messenger_->DeclareProperty("eventSeeding", event_seeding_, 
+        "Seed every event from (run seed, event ID), independently of the threads.");
+  eventSeedingCmd.SetParameterName("flag", true);
+  eventSeedingCmd.SetDefaultValue("true");
+
+  // replayEvent command
+  auto& replayCmd
+    = messenger_->DeclareProperty("replayEvent", replay_event_, 
+        "Seed every event as this event ID, with tracking verbose 2 (-1 : off).");
+  replayCmd.SetParameterName("eventID", true);
+  replayCmd.SetRange("eventID>=-1");
+  replayCmd.SetDefaultValue("-1");
+
+  // eventOffset command
+  auto& offsetCmd
+    = messenger_->DeclareProperty("eventOffset", event_offset_, 
+        "Offset added to the event IDs of event seeding (share of a process).");
+  offsetCmd.SetParameterName("offset", false);
+  offsetCmd.SetRange("offset>=0");
+
+  // timingReport command
+  auto& reportCmd
+    = messenger_->DeclareProperty("timingReport", timing_report_, 
+        "File to which the master writes the run timing report.");
+  reportCmd.SetParameterName("file", true);
+  reportCmd.SetDefaultValue("");
+
+  // Define /proton_pol/asymmetry command directory
+  asymmetry_messenger_ 
+    = new G4GenericMessenger(this, 
+        "/proton_pol/asymmetry/", 
+        "Streaming asymmetry estimator");
+
+  // thetaBins, thetaMin, thetaMax commands (applied at the next run)
+  auto& binsCmd
+    = asymmetry_messenger_->DeclareProperty("thetaBins", theta_bins_, 
+        "Number of theta bins.");
+  binsCmd.SetParameterName("n", false);
+  binsCmd.SetRange("n>=1");
+
+  auto& thetaMinCmd
+    = asymmetry_messenger_->DeclarePropertyWithUnit("thetaMin", "deg", theta_min_, 
+        "Lower edge of the theta bins.");
+  thetaMinCmd.SetParameterName("theta", false);
+
+  auto& thetaMaxCmd
+    = asymmetry_messenger_->DeclarePropertyWithUnit("thetaMax", "deg", theta_max_, 
+        "Upper edge of the theta bins.");
+  thetaMaxCmd.SetParameterName("theta", false);
+
+  // beamPolarization command
+  auto& polarizationCmd
+    = asymmetry_messenger_->DeclareProperty("beamPolarization", beam_polarization_, 
+        "Beam polarization used to convert asymmetries to analyzing powers.");
+  polarizationCmd.SetParameterName("P", false);
+
+  // file command
+  auto& fileCmd
+    = asymmetry_messenger_->DeclareProperty("file", asymmetry_file_, 
+        "CSV file written at the end of run (empty : none).");
+  fileCmd.SetParameterName("file", true);
+  fileCmd.SetDefaultValue("");
+
+  // stateFile command
+  auto& stateCmd
+    = asymmetry_messenger_->DeclareProperty("stateFile", asymmetry_state_file_, 
+        "Raw sums written at the end of run, for proton_pol_merge (empty : none).");
+  stateCmd.SetParameterName("file", true);
+  stateCmd.SetDefaultValue("");
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
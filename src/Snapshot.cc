@@ -0,0 +1,289 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file Snapshot.cc
+/// \brief Implementation of the Snapshot class
+
+#include "Snapshot.hh"
+#include "Run.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+Snapshot* Snapshot::fgInstance = nullptr;
+G4ThreadLocal Snapshot::Slot* Snapshot::fgSlot = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Snapshot* Snapshot::Instance()
+{
+  // first called by the master RunAction, before the workers start
+  if (!fgInstance) fgInstance = new Snapshot;
+  return fgInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Snapshot::Snapshot()
+: messenger_(nullptr), 
+  interval_(0.), events_(10000), file_("proton_pol_snapshot"), polarization_(1.),
+  stop_(false)
+{
+  // define commands for this class
+  DefineCommands();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Snapshot::~Snapshot()
+{
+  Stop();
+  delete messenger_;
+  fgInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Snapshot::Publish(const Run* run)
+{
+  if (interval_ <= 0.) return;
+  G4long events = run->GetNumberOfEvent() + 1;  // this event is not yet recorded
+  if (events % events_ != 0) return;
+
+  if (!fgSlot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    slots_.emplace_back(new Slot);
+    fgSlot = slots_.back().get();
+  }
+
+  // copy into the back buffer (only this thread swaps the buffers)
+  auto analysisManager = G4AnalysisManager::Instance();
+  auto& back = fgSlot->buffers[1 - fgSlot->front];
+  back.events = events;
+  auto nof_h1 = analysisManager->GetNofH1s();
+  back.h1.clear();
+  for (auto i_h1 = 0; i_h1 < nof_h1; ++i_h1) {
+    back.h1.push_back(*analysisManager->GetH1(analysisManager->GetFirstH1Id() + i_h1));
+  }
+  auto nof_h2 = analysisManager->GetNofH2s();
+  back.h2.clear();
+  for (auto i_h2 = 0; i_h2 < nof_h2; ++i_h2) {
+    back.h2.push_back(*analysisManager->GetH2(analysisManager->GetFirstH2Id() + i_h2));
+  }
+  back.asymmetry = run->GetAsymmetry();
+
+  std::lock_guard<std::mutex> lock(fgSlot->mutex);
+  fgSlot->front = 1 - fgSlot->front;
+  fgSlot->valid = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Snapshot::Start(G4double polarization)
+{
+  Stop();
+  if (interval_ <= 0.) return;
+
+  polarization_ = polarization;
+
+  // histogram names (the same on every thread)
+  auto analysisManager = G4AnalysisManager::Instance();
+  h1_names_.clear();
+  for (auto i_h1 = 0; i_h1 < analysisManager->GetNofH1s(); ++i_h1) {
+    h1_names_.push_back(analysisManager->GetH1Name(analysisManager->GetFirstH1Id() + i_h1));
+  }
+  h2_names_.clear();
+  for (auto i_h2 = 0; i_h2 < analysisManager->GetNofH2s(); ++i_h2) {
+    h2_names_.push_back(analysisManager->GetH2Name(analysisManager->GetFirstH2Id() + i_h2));
+  }
+
+  // the copies of the previous run are not published any more
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& slot : slots_) {
+      std::lock_guard<std::mutex> slot_lock(slot->mutex);
+      slot->valid = false;
+    }
+  }
+
+  stop_ = false;
+  thread_ = std::thread([this]() {
+    std::chrono::duration<G4double> interval(interval_/s);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_condition_.wait_for(lock, interval, [this]() { return stop_; })) {
+      lock.unlock();
+      Write();
+      lock.lock();
+    }
+  });
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Snapshot::Stop()
+{
+  if (!thread_.joinable()) return;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  stop_condition_.notify_one();
+  thread_.join();
+  Write();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Snapshot::Write()
+{
+  // merge the front buffers of all threads
+  Buffer merged;
+  G4bool empty = true;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& slot : slots_) {
+      std::lock_guard<std::mutex> slot_lock(slot->mutex);
+      if (!slot->valid) continue;
+      const auto& front = slot->buffers[slot->front];
+      if (empty) {
+        merged = front;
+        empty = false;
+        continue;
+      }
+      merged.events += front.events;
+      for (std::size_t i_h1 = 0; i_h1 < merged.h1.size(); ++i_h1) {
+        merged.h1[i_h1].add(front.h1[i_h1]);
+      }
+      for (std::size_t i_h2 = 0; i_h2 < merged.h2.size(); ++i_h2) {
+        merged.h2[i_h2].add(front.h2[i_h2]);
+      }
+      merged.asymmetry.Merge(front.asymmetry);
+    }
+  }
+  if (empty) return;
+
+  // replace the previous snapshot
+  auto csv = file_ + ".csv", histos = file_ + "_histos.txt";
+  auto ok = merged.asymmetry.Write(csv + ".tmp", polarization_)
+         && std::rename((csv + ".tmp").c_str(), csv.c_str()) == 0;
+  ok = ok && WriteHistograms(histos + ".tmp", merged)
+          && std::rename((histos + ".tmp").c_str(), histos.c_str()) == 0;
+  if (!ok) {
+    G4ExceptionDescription msg;
+    msg << "Cannot write the snapshot " << file_ << G4endl;
+    G4Exception("Snapshot::Write()",
+                "Code001", JustWarning, msg);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Snapshot::WriteHistograms(const G4String& path, const Buffer& merged) const
+{
+  std::ofstream output(path);
+  if (!output) return false;
+
+  output << "# proton_pol snapshot : " << merged.events << " events\n"
+         << "# h1 name nbins xmin xmax entries, then per bin : lower edge, height, error\n"
+         << "# h2 name nx xmin xmax ny ymin ymax entries, then per filled bin :"
+         << " x lower edge, y lower edge, height, error\n"
+         << std::setprecision(8);
+
+  for (std::size_t i_h1 = 0; i_h1 < merged.h1.size(); ++i_h1) {
+    const auto& h1 = merged.h1[i_h1];
+    const auto& axis = h1.axis();
+    output << "h1 " << h1_names_[i_h1] << " " << axis.bins() << " " 
+           << axis.lower_edge() << " " << axis.upper_edge() << " " << h1.entries() << "\n";
+    for (auto i_bin = 0; i_bin < (G4int)axis.bins(); ++i_bin) {
+      output << axis.bin_lower_edge(i_bin) << " " 
+             << h1.bin_height(i_bin) << " " << h1.bin_error(i_bin) << "\n";
+    }
+  }
+
+  for (std::size_t i_h2 = 0; i_h2 < merged.h2.size(); ++i_h2) {
+    const auto& h2 = merged.h2[i_h2];
+    const auto& x = h2.axis_x();
+    const auto& y = h2.axis_y();
+    output << "h2 " << h2_names_[i_h2] << " " 
+           << x.bins() << " " << x.lower_edge() << " " << x.upper_edge() << " "
+           << y.bins() << " " << y.lower_edge() << " " << y.upper_edge() << " "
+           << h2.entries() << "\n";
+    for (auto i_x = 0; i_x < (G4int)x.bins(); ++i_x) {
+      for (auto i_y = 0; i_y < (G4int)y.bins(); ++i_y) {
+        auto height = h2.bin_height(i_x, i_y);
+        if (height == 0.) continue;
+        output << x.bin_lower_edge(i_x) << " " << y.bin_lower_edge(i_y) << " "
+               << height << " " << h2.bin_error(i_x, i_y) << "\n";
+      }
+    }
+  }
+  return (bool)output;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Snapshot::DefineCommands()
+{
+  // Define /proton_pol/snapshot command directory using generic messenger class
+  messenger_ 
+    = new G4GenericMessenger(this, 
+        "/proton_pol/snapshot/", 
+        "In-flight snapshots of the histograms and of the asymmetry");
+
+  // interval command
+  auto& intervalCmd
+    = messenger_->DeclarePropertyWithUnit("interval", "s", interval_, 
+        "Wall-clock interval between two snapshot files (0 : off).");
+  intervalCmd.SetParameterName("interval", false);
+  intervalCmd.SetRange("interval>=0.");
+  intervalCmd.SetStates(G4State_PreInit, G4State_Idle);
+  intervalCmd.SetToBeBroadcasted(false);
+
+  // events command
+  auto& eventsCmd
+    = messenger_->DeclareProperty("events", events_, 
+        "Events between two copies published by each thread.");
+  eventsCmd.SetParameterName("events", false);
+  eventsCmd.SetRange("events>=1");
+  eventsCmd.SetStates(G4State_PreInit, G4State_Idle);
+  eventsCmd.SetToBeBroadcasted(false);
+
+  // file command
+  auto& fileCmd
+    = messenger_->DeclareProperty("file", file_, 
+        "Base name of the snapshot files (<file>.csv, <file>_histos.txt).");
+  fileCmd.SetParameterName("file", false);
+  fileCmd.SetStates(G4State_PreInit, G4State_Idle);
+  fileCmd.SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
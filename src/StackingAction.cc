@@ -0,0 +1,136 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StackingAction.cc
+/// \brief Implementation of the StackingAction class
+
+#include "StackingAction.hh"
+#include "Run.hh"
+#include "Telemetry.hh"
+
+#include "G4Track.hh"
+#include "G4RunManager.hh"
+#include "G4GenericMessenger.hh"
+#include "G4SystemOfUnits.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingAction::StackingAction()
+: G4UserStackingAction(),
+  messenger_(nullptr),
+  kill_neutrals_(false),
+  energy_threshold_(0.),
+  acceptance_angle_(180.*deg),
+  time_cut_(0.)
+{
+  // define commands for this class
+  DefineCommands();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingAction::~StackingAction()
+{
+  delete messenger_;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack(const G4Track* track)
+{
+  if (track->GetParentID() == 0) return fUrgent;
+
+  if (time_cut_ > 0. && track->GetGlobalTime() > time_cut_) {
+    return Kill(kKillLateTime);
+  }
+
+  auto charge = track->GetDefinition()->GetPDGCharge();
+  if (charge == 0.) {
+    return kill_neutrals_ ? Kill(kKillNeutral) : fUrgent;
+  }
+
+  if (track->GetKineticEnergy() < energy_threshold_) {
+    return Kill(kKillLowEnergy);
+  }
+
+  if (track->GetMomentumDirection().theta() > acceptance_angle_) {
+    return Kill(kKillAcceptance);
+  }
+
+  return fUrgent;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ClassificationOfNewTrack StackingAction::Kill(StackingRule rule) const
+{
+  auto run = static_cast<Run*>(
+      G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  if (run) run->AddKilledTrack(rule);
+  Telemetry::Instance()->AddKilledTrack();
+  return fKill;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::DefineCommands()
+{
+  // Define /proton_pol/stack command directory using generic messenger class
+  messenger_ 
+    = new G4GenericMessenger(this, 
+        "/proton_pol/stack/", 
+        "Track culling of the stacking action");
+
+  // killNeutrals command
+  auto& neutralCmd
+    = messenger_->DeclareProperty("killNeutrals", kill_neutrals_, 
+        "Kill neutral secondaries.");
+  neutralCmd.SetParameterName("flag", true);
+  neutralCmd.SetDefaultValue("true");
+
+  // energyThreshold command
+  auto& energyCmd
+    = messenger_->DeclarePropertyWithUnit("energyThreshold", "MeV", energy_threshold_, 
+        "Kill charged secondaries below this kinetic energy (0 : off).");
+  energyCmd.SetParameterName("E", false);
+  energyCmd.SetRange("E>=0.");
+
+  // acceptanceAngle command
+  auto& angleCmd
+    = messenger_->DeclarePropertyWithUnit("acceptanceAngle", "deg", acceptance_angle_, 
+        "Kill charged secondaries heading outside this cone around +z (180 deg : off).");
+  angleCmd.SetParameterName("angle", false);
+  angleCmd.SetRange("angle>0.");
+
+  // timeCut command
+  auto& timeCmd
+    = messenger_->DeclarePropertyWithUnit("timeCut", "ns", time_cut_, 
+        "Kill secondaries created after this global time (0 : off).");
+  timeCmd.SetParameterName("t", false);
+  timeCmd.SetRange("t>=0.");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,170 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StartupTimer.cc
+/// \brief Implementation of the StartupTimer class
+
+#include "StartupTimer.hh"
+
+#include "G4StateManager.hh"
+#include "G4VStateDependent.hh"
+#include "G4Threading.hh"
+
+#include <algorithm>
+#include <fstream>
+
+namespace {
+
+// Times the initialization phases from the state transitions of a thread
+// (the state manager is thread-local and owns its dependents)
+class StateObserver : public G4VStateDependent
+{
+  public:
+    StateObserver() : G4VStateDependent(), run_initialized_(false) {}
+
+    virtual G4bool Notify(G4ApplicationState requested_state)
+    {
+      auto timer = StartupTimer::Instance();
+      auto state = G4StateManager::GetStateManager()->GetCurrentState();
+      if (state == G4State_PreInit && requested_state == G4State_Init) {
+        timer->Start("Initialize");
+      }
+      else if (state == G4State_Idle && requested_state == G4State_Init
+               && !run_initialized_) {
+        timer->Start("RunInitialization");
+      }
+      else if (state == G4State_Init && requested_state == G4State_Idle) {
+        timer->Stop("Initialize");
+        if (!run_initialized_) {
+          // only the Idle -> Init transitions of runs are started
+          timer->Stop("RunInitialization");
+          run_initialized_ = true;
+        }
+      }
+      return true;
+    }
+
+  private:
+    G4bool run_initialized_;
+};
+
+G4ThreadLocal StateObserver* observer = nullptr;
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StartupTimer* StartupTimer::Instance()
+{
+  static StartupTimer instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StartupTimer::StartupTimer()
+: job_start_(std::chrono::steady_clock::now())
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StartupTimer::~StartupTimer()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double StartupTimer::GetTime() const
+{
+  std::chrono::duration<G4double> time 
+    = std::chrono::steady_clock::now() - job_start_;
+  return time.count();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StartupTimer::Start(const G4String& phase)
+{
+  auto time = GetTime();
+  std::lock_guard<std::mutex> lock(mutex_);
+  started_[std::make_pair(G4Threading::G4GetThreadId(), phase)] = time;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StartupTimer::Stop(const G4String& phase)
+{
+  auto time = GetTime();
+  auto thread = G4Threading::G4GetThreadId();
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto started = started_.find(std::make_pair(thread, phase));
+  if (started == started_.end()) return;
+  records_.push_back({thread, phase, started->second, time - started->second});
+  started_.erase(started);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StartupTimer::ObserveStates()
+{
+  if (!observer) observer = new StateObserver();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool StartupTimer::Write(const G4String& path) const
+{
+  std::ofstream report(path);
+  if (!report) return false;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // group the phases by thread (master = -1 first), in start order
+  auto records = records_;
+  std::stable_sort(records.begin(), records.end(),
+    [](const Record& a, const Record& b) 
+    { return a.thread != b.thread ? a.thread < b.thread : a.start < b.start; });
+
+  report << "{\n  \"job\": " << GetTime() << ",\n  \"threads\": [";
+  for (size_t i = 0; i < records.size(); ++i) {
+    const auto& record = records[i];
+    auto first = (i == 0 || records[i-1].thread != record.thread);
+    auto last = (i+1 == records.size() || records[i+1].thread != record.thread);
+    if (first) {
+      report << (i ? ",\n" : "\n") << "    {\"thread\": ";
+      if (record.thread < 0) report << "\"master\"";
+      else report << "\"worker " << record.thread << "\"";
+      report << ", \"phases\": [\n";
+    }
+    report << "      {\"name\": \"" << record.phase << "\""
+           << ", \"start\": " << record.start 
+           << ", \"seconds\": " << record.duration << "}"
+           << (last ? "\n    ]}" : ",\n");
+  }
+  report << "\n  ]\n}\n";
+  return (bool)report;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,122 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SteppingAction.cc
+/// \brief Implementation of the SteppingAction class
+
+#include "SteppingAction.hh"
+#include "Run.hh"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4RunManager.hh"
+#include "G4GenericMessenger.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SteppingAction::SteppingAction()
+: G4UserSteppingAction(),
+  messenger_(nullptr),
+  profile_(false),
+  sample_period_(100),
+  steps_to_sample_(0),
+  timed_track_(nullptr),
+  timed_step_(0)
+{
+  // define commands for this class
+  DefineCommands();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SteppingAction::~SteppingAction()
+{
+  delete messenger_;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SteppingAction::UserSteppingAction(const G4Step* step)
+{
+  if (!profile_) return;
+
+  auto run = static_cast<Run*>(
+      G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  auto track = step->GetTrack();
+  auto& entry = run->GetSteppingProfile().GetEntry(
+      step->GetPreStepPoint()->GetPhysicalVolume(),
+      step->GetPostStepPoint()->GetProcessDefinedStep(),
+      track->GetDefinition());
+  ++entry.steps;
+  entry.length += step->GetStepLength();
+
+  if (sample_period_ <= 0) return;
+
+  // this step was computed since the armed timer started
+  if (timed_track_) {
+    if (track == timed_track_ && track->GetCurrentStepNumber() == timed_step_+1) {
+      std::chrono::duration<G4double> time 
+        = std::chrono::steady_clock::now() - timed_start_;
+      entry.time += time.count();
+      ++entry.time_samples;
+    }
+    timed_track_ = nullptr;
+  }
+
+  if (++steps_to_sample_ >= sample_period_) {
+    steps_to_sample_ = 0;
+    timed_track_ = track;
+    timed_step_ = track->GetCurrentStepNumber();
+    timed_start_ = std::chrono::steady_clock::now();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SteppingAction::DefineCommands()
+{
+  // Define /proton_pol/profile command directory using generic messenger class
+  messenger_ 
+    = new G4GenericMessenger(this, 
+        "/proton_pol/profile/", 
+        "Stepping profiler");
+
+  // enable command
+  auto& enableCmd
+    = messenger_->DeclareProperty("enable", profile_, 
+        "Profile steps per (volume, process, particle).");
+  enableCmd.SetParameterName("flag", true);
+  enableCmd.SetDefaultValue("true");
+
+  // samplePeriod command
+  auto& periodCmd
+    = messenger_->DeclareProperty("samplePeriod", sample_period_, 
+        "Time one step out of this many (0 : no timing).");
+  periodCmd.SetParameterName("period", false);
+  periodCmd.SetRange("period>=0");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
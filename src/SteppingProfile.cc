@@ -0,0 +1,177 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SteppingProfile.cc
+/// \brief Implementation of the SteppingProfile class
+
+#include "SteppingProfile.hh"
+
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <iomanip>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SteppingProfile::SteppingProfile()
+: last_volume_(nullptr), last_process_(nullptr), last_particle_(nullptr),
+  last_entry_(nullptr)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SteppingProfile::~SteppingProfile()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SteppingProfile::Entry& SteppingProfile::FindEntry(
+  const G4VPhysicalVolume* volume, const G4VProcess* process,
+  const G4ParticleDefinition* particle)
+{
+  // entries are nodes of the map: their address is stable (cached entry)
+  return entries_[Pack(GetIndex(kVolume, volume), 
+                       GetIndex(kProcess, process),
+                       GetIndex(kParticle, particle))];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+uint64_t SteppingProfile::GetIndex(G4int category, const void* object)
+{
+  auto found = object_index_[category].find(object);
+  if (found != object_index_[category].end()) return found->second;
+
+  G4String name = "none";
+  if (object) {
+    if (category == kVolume) {
+      name = static_cast<const G4VPhysicalVolume*>(object)->GetName();
+    } else if (category == kProcess) {
+      name = static_cast<const G4VProcess*>(object)->GetProcessName();
+    } else {
+      name = static_cast<const G4ParticleDefinition*>(object)->GetParticleName();
+    }
+  }
+  auto index = GetIndex(category, name);
+  object_index_[category][object] = index;
+  return index;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+uint64_t SteppingProfile::GetIndex(G4int category, const G4String& name)
+{
+  auto found = name_index_[category].find(name);
+  if (found != name_index_[category].end()) return found->second;
+
+  uint64_t index = names_[category].size();
+  names_[category].push_back(name);
+  name_index_[category][name] = index;
+  return index;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SteppingProfile::Merge(const SteppingProfile& profile)
+{
+  // the numbering differs between threads: merge by name
+  const uint64_t mask = (1ULL << 21) - 1;
+  for (const auto& entry : profile.entries_) {
+    auto volume = (entry.first >> 42) & mask;
+    auto process = (entry.first >> 21) & mask;
+    auto particle = entry.first & mask;
+    auto& sum = entries_[Pack(
+      GetIndex(kVolume, profile.names_[kVolume][volume]),
+      GetIndex(kProcess, profile.names_[kProcess][process]),
+      GetIndex(kParticle, profile.names_[kParticle][particle]))];
+    sum.steps += entry.second.steps;
+    sum.length += entry.second.length;
+    sum.time_samples += entry.second.time_samples;
+    sum.time += entry.second.time;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SteppingProfile::Print(std::ostream& output, G4int lines) const
+{
+  // estimated time = mean sampled step time x steps
+  struct Line {
+    uint64_t key;
+    const Entry* entry;
+    G4double time;
+  };
+  std::vector<Line> hot_list;
+  G4long total_steps = 0;
+  G4double total_time = 0.;
+  for (const auto& entry : entries_) {
+    const auto& value = entry.second;
+    auto time = value.time_samples > 0 
+                ? value.time/value.time_samples*value.steps : 0.;
+    hot_list.push_back({entry.first, &value, time});
+    total_steps += value.steps;
+    total_time += time;
+  }
+  // by estimated time, then by steps when no time was sampled
+  std::sort(hot_list.begin(), hot_list.end(), 
+    [](const Line& a, const Line& b) {
+      return a.time != b.time ? a.time > b.time : a.entry->steps > b.entry->steps; 
+    });
+
+  const uint64_t mask = (1ULL << 21) - 1;
+  auto precision = output.precision();
+  output << "--------------------------- Stepping profile ---------------------------"
+         << std::endl
+         << std::left << std::setw(26) << " volume" << std::setw(18) << "process"
+         << std::setw(10) << "particle" << std::right
+         << std::setw(12) << "steps" << std::setw(12) << "length[mm]"
+         << std::setw(10) << "time[s]" << std::setw(8) << "time%" << std::endl;
+  auto n_lines = std::min<size_t>(lines, hot_list.size());
+  for (size_t i_line = 0; i_line < n_lines; ++i_line) {
+    const auto& line = hot_list[i_line];
+    output << " " << std::left 
+           << std::setw(25) << names_[kVolume][(line.key >> 42) & mask]
+           << std::setw(18) << names_[kProcess][(line.key >> 21) & mask]
+           << std::setw(10) << names_[kParticle][line.key & mask]
+           << std::right
+           << std::setw(12) << line.entry->steps
+           << std::setw(12) << std::setprecision(4) << line.entry->length/mm
+           << std::setw(10) << std::setprecision(3) << line.time
+           << std::setw(7) << std::fixed << std::setprecision(1)
+           << (total_time > 0. ? 100.*line.time/total_time : 0.) << "%"
+           << std::defaultfloat << std::setprecision(precision) << std::endl;
+  }
+  output << " total : " << total_steps << " steps, " << entries_.size() 
+         << " (volume, process, particle), estimated " << total_time << " s"
+         << std::endl
+         << "------------------------------------------------------------------------"
+         << std::endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
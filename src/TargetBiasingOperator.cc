@@ -0,0 +1,134 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file TargetBiasingOperator.cc
+/// \brief Implementation of the TargetBiasingOperator class
+
+#include "TargetBiasingOperator.hh"
+
+#include "G4BiasingProcessInterface.hh"
+#include "G4BiasingProcessSharedData.hh"
+#include "G4BOptnChangeCrossSection.hh"
+#include "G4ParticleTable.hh"
+#include "G4ProcessManager.hh"
+#include "G4Track.hh"
+
+#include <cfloat>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double TargetBiasingOperator::fgFactor = 50.;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TargetBiasingOperator::TargetBiasingOperator(const G4String& particle_name)
+: G4VBiasingOperator("TargetBiasingOperator"),
+  particle_(nullptr),
+  setup_(true)
+{
+  particle_ = G4ParticleTable::GetParticleTable()->FindParticle(particle_name);
+  if (!particle_) {
+    G4ExceptionDescription msg;
+    msg << "Particle " << particle_name << " not found." << G4endl;
+    G4Exception("TargetBiasingOperator::TargetBiasingOperator()",
+                "Code001", JustWarning, msg);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TargetBiasingOperator::~TargetBiasingOperator()
+{
+  for (auto& operation : operations_) delete operation.second;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TargetBiasingOperator::StartRun()
+{
+  // one cross section change operation per wrapped process (once per thread)
+  if (!setup_ || !particle_) return;
+
+  auto sharedData 
+    = G4BiasingProcessInterface::GetSharedData(particle_->GetProcessManager());
+  if (sharedData) {
+    for (auto wrapper : sharedData->GetPhysicsBiasingProcessInterfaces()) {
+      G4String name = "XSchange-" + wrapper->GetWrappedProcess()->GetProcessName();
+      operations_[wrapper] = new G4BOptnChangeCrossSection(name);
+    }
+  }
+  setup_ = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VBiasingOperation* 
+TargetBiasingOperator::ProposeOccurenceBiasingOperation(const G4Track* track,
+    const G4BiasingProcessInterface* callingProcess)
+{
+  // primary protons only, the secondaries are tracked analog
+  if (track->GetDefinition() != particle_ || track->GetParentID() != 0) return nullptr;
+  if (fgFactor == 1.) return nullptr;
+
+  auto analog_length = callingProcess->GetWrappedProcess()->GetCurrentInteractionLength();
+  if (analog_length > DBL_MAX/10.) return nullptr;
+  auto biased_cross_section = fgFactor/analog_length;
+
+  auto found = operations_.find(callingProcess);
+  if (found == operations_.end()) return nullptr;
+  auto operation = found->second;
+
+  auto previous = callingProcess->GetPreviousOccurenceBiasingOperation();
+  if (previous == nullptr || operation->GetInteractionOccured()) {
+    // new interaction length sampled with the biased cross section
+    operation->SetBiasedCrossSection(biased_cross_section);
+    operation->Sample();
+  }
+  else {
+    // the cross section may have changed along the previous step
+    operation->UpdateForStep(callingProcess->GetPreviousStepSize());
+    operation->SetBiasedCrossSection(biased_cross_section);
+    operation->UpdateForStep(0.);
+  }
+
+  return operation;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TargetBiasingOperator::OperationApplied(const G4BiasingProcessInterface* callingProcess,
+                                             G4BiasingAppliedCase,
+                                             G4VBiasingOperation* occurenceOperationApplied,
+                                             G4double,
+                                             G4VBiasingOperation*,
+                                             const G4VParticleChange*)
+{
+  auto found = operations_.find(callingProcess);
+  if (found == operations_.end()) return;
+  if (found->second == occurenceOperationApplied) found->second->SetInteractionOccured();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,212 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file Telemetry.cc
+/// \brief Implementation of the Telemetry class
+
+#include "Telemetry.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+Telemetry* Telemetry::fgInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Telemetry* Telemetry::Instance()
+{
+  // first called by the master RunAction, before the workers start
+  if (!fgInstance) fgInstance = new Telemetry;
+  return fgInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Telemetry::Telemetry()
+: messenger_(nullptr), 
+  interval_(0.), file_(""),
+  slots_(kMaxSlots), last_events_(kMaxSlots, 0), events_to_process_(0),
+  stop_(false)
+{
+  for (auto& slot : slots_) {
+    slot.events = 0;
+    slot.steps = 0;
+    slot.hits = 0;
+    slot.killed_tracks = 0;
+  }
+
+  // define commands for this class
+  DefineCommands();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Telemetry::~Telemetry()
+{
+  Stop();
+  delete messenger_;
+  fgInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Telemetry::Start(G4long events_to_process)
+{
+  Stop();
+
+  for (auto& slot : slots_) {
+    slot.events = 0;
+    slot.steps = 0;
+    slot.hits = 0;
+    slot.killed_tracks = 0;
+  }
+  std::fill(last_events_.begin(), last_events_.end(), 0);
+  events_to_process_ = events_to_process;
+  run_start_ = last_sample_ = std::chrono::steady_clock::now();
+
+  if (interval_ <= 0.) return;
+
+  stop_ = false;
+  thread_ = std::thread([this]() {
+    std::chrono::duration<G4double> interval(interval_/s);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_condition_.wait_for(lock, interval, [this]() { return stop_; })) {
+      Sample(false);
+    }
+  });
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Telemetry::Stop()
+{
+  if (!thread_.joinable()) return;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  stop_condition_.notify_one();
+  thread_.join();
+  Sample(true);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Telemetry::Sample(G4bool last)
+{
+  auto now = std::chrono::steady_clock::now();
+  std::chrono::duration<G4double> time = now - run_start_;
+  std::chrono::duration<G4double> period = now - last_sample_;
+  last_sample_ = now;
+
+  G4long events = 0, steps = 0, hits = 0, killed_tracks = 0;
+  std::ostringstream threads;
+  for (auto i_slot = 0; i_slot < kMaxSlots; ++i_slot) {
+    auto& slot = slots_[i_slot];
+    auto slot_events = slot.events.load(std::memory_order_relaxed);
+    events += slot_events;
+    steps += slot.steps.load(std::memory_order_relaxed);
+    hits += slot.hits.load(std::memory_order_relaxed);
+    killed_tracks += slot.killed_tracks.load(std::memory_order_relaxed);
+    if (slot_events == 0) continue;
+
+    auto rate = (slot_events - last_events_[i_slot])/period.count();
+    last_events_[i_slot] = slot_events;
+    threads << (threads.tellp() > 0 ? ", " : "") 
+            << "{\"thread\": " << i_slot - 1 << ", \"events\": " << slot_events 
+            << ", \"rate\": " << rate << "}";
+  }
+
+  auto rate = events/time.count();
+  auto eta = (rate > 0. && events_to_process_ > events) 
+             ? (events_to_process_ - events)/rate : 0.;
+
+  std::ostringstream line;
+  line << "{\"time\": " << time.count()
+       << ", \"last\": " << (last ? "true" : "false")
+       << ", \"events\": " << events << ", \"to_process\": " << events_to_process_
+       << ", \"rate\": " << rate << ", \"eta\": " << eta
+       << ", \"steps\": " << steps << ", \"hits\": " << hits 
+       << ", \"killed_tracks\": " << killed_tracks
+       << ", \"rss_mb\": " << GetResidentMemory()
+       << ", \"threads\": [" << threads.str() << "]}\n";
+
+  // the sampling thread is not a Geant4 thread: no G4cout
+  if (file_.empty()) {
+    std::cout << "Telemetry: " << line.str() << std::flush;
+  } 
+  else {
+    std::ofstream output(file_, std::ios::app);
+    output << line.str();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double Telemetry::GetResidentMemory() const
+{
+  // resident pages of the process
+  std::ifstream statm("/proc/self/statm");
+  long size = 0, resident = 0;
+  if (!(statm >> size >> resident)) return 0.;
+  return resident*(G4double)sysconf(_SC_PAGESIZE)/(1024.*1024.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Telemetry::DefineCommands()
+{
+  // Define /proton_pol/telemetry command directory using generic messenger class
+  messenger_ 
+    = new G4GenericMessenger(this, 
+        "/proton_pol/telemetry/", 
+        "Live throughput telemetry");
+
+  // interval command
+  auto& intervalCmd
+    = messenger_->DeclarePropertyWithUnit("interval", "s", interval_, 
+        "Wall-clock interval of the telemetry lines (0 : off).");
+  intervalCmd.SetParameterName("interval", false);
+  intervalCmd.SetRange("interval>=0.");
+  intervalCmd.SetToBeBroadcasted(false);
+
+  // file command
+  auto& fileCmd
+    = messenger_->DeclareProperty("file", file_, 
+        "File to which the JSON lines are appended (empty : standard output).");
+  fileCmd.SetParameterName("file", true);
+  fileCmd.SetDefaultValue("");
+  fileCmd.SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,182 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ThreadScalingBenchmark.cc
+/// \brief Implementation of the ThreadScalingBenchmark class
+
+#include "ThreadScalingBenchmark.hh"
+#include "CommandLineOptions.hh"
+
+#include "G4ios.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace {
+
+// default workload of the benchmark
+constexpr G4int kDefaultEvents = 1000;
+constexpr G4long kDefaultSeed = 12345;
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ThreadScalingBenchmark::ThreadScalingBenchmark(const G4String& program,
+                                               const CommandLineOptions& options)
+: program_(program), options_(options)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ThreadScalingBenchmark::~ThreadScalingBenchmark()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ThreadScalingBenchmark::Execute()
+{
+  auto max_threads = options_.GetScalingThreads();
+
+  // 1,2,4,...,max_threads (max_threads is always included)
+  std::vector<G4int> thread_counts;
+  for (auto threads = 1; threads < max_threads; threads *= 2) {
+    thread_counts.push_back(threads);
+  }
+  thread_counts.push_back(max_threads);
+
+  std::vector<Measurement> measurements;
+  for (auto threads : thread_counts) {
+    Measurement measurement;
+    if (!Measure(threads, measurement)) return 1;
+    measurements.push_back(measurement);
+  }
+
+  PrintTable(measurements);
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ThreadScalingBenchmark::Measure(G4int threads, Measurement& measurement) const
+{
+  auto events = options_.GetEvents() ? options_.GetEvents() : kDefaultEvents;
+  auto seed = options_.GetSeed() ? options_.GetSeed() : kDefaultSeed;
+
+  std::ostringstream report_name, log_name;
+  report_name << "proton_pol_scaling_" << threads << ".txt";
+  log_name << "proton_pol_scaling_" << threads << ".log";
+
+  std::ostringstream command;
+  command << "\"" << program_ << "\""
+          << " --run-manager " << options_.GetRunManagerName()
+          << " --threads " << threads
+          << " --events " << events
+          << " --seed " << seed
+          << " --timing-report " << report_name.str()
+          << " --physics " << options_.GetPhysicsList();
+  if (options_.GetMomentum() > 0.) {
+    command << " --momentum " << options_.GetMomentum();
+  }
+  if (!options_.GetMacro().empty()) {
+    command << " --macro \"" << options_.GetMacro() << "\"";
+  }
+  command << " > " << log_name.str() << " 2>&1";
+
+  G4cout << "ThreadScalingBenchmark: " << threads << " thread(s), "
+         << events << " events ..." << G4endl;
+  if (std::system(command.str().c_str()) != 0) {
+    G4cerr << "ThreadScalingBenchmark: run with " << threads 
+           << " thread(s) failed, see " << log_name.str() << G4endl;
+    return false;
+  }
+
+  // read back the timing report written by RunAction
+  std::ifstream report(report_name.str());
+  if (!report) {
+    G4cerr << "ThreadScalingBenchmark: no timing report "
+           << report_name.str() << G4endl;
+    return false;
+  }
+  measurement.threads = threads;
+  measurement.events = 0;
+  measurement.wall_time = 0.;
+  measurement.busy_times.clear();
+
+  std::string line;
+  while (std::getline(report, line)) {
+    std::istringstream tokens(line);
+    std::string key;
+    tokens >> key;
+    if (key == "events") tokens >> measurement.events;
+    else if (key == "wall") tokens >> measurement.wall_time;
+    else if (key == "busy") {
+      G4double busy_time;
+      while (tokens >> busy_time) measurement.busy_times.push_back(busy_time);
+    }
+  }
+  report.close();
+  std::remove(report_name.str().c_str());
+
+  return measurement.wall_time > 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ThreadScalingBenchmark::PrintTable(const std::vector<Measurement>& measurements) const
+{
+  auto reference_rate = measurements[0].events/measurements[0].wall_time;
+
+  G4cout << G4endl
+         << "------------------- Thread scaling (" << options_.GetRunManagerName()
+         << ") -------------------" << G4endl
+         << " threads    events/s   speed-up  efficiency  idle/thread" << G4endl;
+  for (const auto& measurement : measurements) {
+    auto rate = measurement.events/measurement.wall_time;
+    auto speedup = rate/reference_rate;
+    auto efficiency = speedup/measurement.threads;
+
+    G4double idle_time = 0.;
+    for (auto busy_time : measurement.busy_times) {
+      idle_time += std::max(0., measurement.wall_time - busy_time);
+    }
+    if (!measurement.busy_times.empty()) idle_time /= measurement.busy_times.size();
+
+    G4cout << std::setw(8) << measurement.threads
+           << std::setw(12) << std::setprecision(4) << rate
+           << std::setw(11) << std::setprecision(3) << speedup
+           << std::setw(11) << std::setprecision(1) << std::fixed << 100.*efficiency << " %"
+           << std::setw(10) << std::setprecision(3) << idle_time << " s"
+           << std::defaultfloat << G4endl;
+  }
+  G4cout << "------------------------------------------------------------------" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,336 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file UnbinnedFit.cc
+/// \brief Implementation of the UnbinnedFit class
+
+#include "UnbinnedFit.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+// events evaluated together
+const std::size_t kChunk = 512;
+
+// sum of a[i] b[i] over a chunk, in four partial sums the compiler keeps 
+// in vector lanes
+inline double Dot(const double* a, const float* b, std::size_t n)
+{
+  double sum[4] = { 0., 0., 0., 0. };
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    for (auto lane = 0; lane < 4; ++lane) sum[lane] += a[i+lane]*b[i+lane];
+  }
+  for (; i < n; ++i) sum[0] += a[i]*b[i];
+  return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+// sum of a[i] b[i] c[i] over a chunk
+inline double Dot(const double* a, const float* b, const float* c, std::size_t n)
+{
+  double sum[4] = { 0., 0., 0., 0. };
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    for (auto lane = 0; lane < 4; ++lane) sum[lane] += a[i+lane]*b[i+lane]*c[i+lane];
+  }
+  for (; i < n; ++i) sum[0] += a[i]*b[i]*c[i];
+  return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+UnbinnedFit::UnbinnedFit(const std::vector<std::string>& names, int partitions)
+: names_(names), 
+  partitions_(partitions > 0 ? partitions : 1),
+  parameters_(names.size(), 0.),
+  covariance_(names.size(), std::vector<double>(names.size(), 0.)),
+  minimum_(0.), iterations_(0)
+{
+  if (names_.size() > kMaxParameters) {
+    names_.resize(kMaxParameters);
+    parameters_.resize(kMaxParameters);
+    covariance_.assign(kMaxParameters, std::vector<double>(kMaxParameters, 0.));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+UnbinnedFit::~UnbinnedFit()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void UnbinnedFit::AddEvent(int partition, const double* features, double weight)
+{
+  auto& events = partitions_[partition];
+  for (std::size_t i_parameter = 0; i_parameter < names_.size(); ++i_parameter) {
+    events.features[i_parameter].push_back(features[i_parameter]);
+  }
+  events.weights.push_back(weight);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool UnbinnedFit::Minimize(int max_iterations, double tolerance)
+{
+  error_.clear();
+  iterations_ = 0;
+  auto nparameters = names_.size();
+
+  Sums sums;
+  Evaluate(parameters_.data(), sums);
+  if (!sums.valid) {
+    error_ = "negative density at the start values";
+    return false;
+  }
+
+  double step[kMaxParameters];
+  double trial[kMaxParameters];
+  auto converged = false;
+  while (iterations_ < max_iterations) {
+    // Newton step, the decrement g.H^-1.g / 2 is the expected gain
+    if (!Solve(sums.hessian, sums.gradient, step)) {
+      error_ = "singular Hessian, the parameters are not constrained by the events";
+      return false;
+    }
+    auto decrement = 0.;
+    for (std::size_t i = 0; i < nparameters; ++i) decrement += sums.gradient[i]*step[i];
+    if (decrement < tolerance) {
+      converged = true;
+      break;
+    }
+    ++iterations_;
+
+    // halved while the density is negative or the likelihood is worse
+    // (within the rounding of the sum over the events)
+    auto worst = sums.nll + 1.e-12*(std::abs(sums.nll) + 1.);
+    Sums trial_sums;
+    auto scale = 1.;
+    auto accepted = false;
+    for (auto i_halving = 0; i_halving < 40 && !accepted; ++i_halving, scale *= 0.5) {
+      for (std::size_t i = 0; i < nparameters; ++i) {
+        trial[i] = parameters_[i] - scale*step[i];
+      }
+      Evaluate(trial, trial_sums);
+      accepted = trial_sums.valid && trial_sums.nll <= worst;
+    }
+    if (!accepted) break;
+    std::copy(trial, trial + nparameters, parameters_.begin());
+    sums = trial_sums;
+  }
+  minimum_ = sums.nll;
+  if (!converged) {
+    error_ = "no convergence after " + std::to_string(iterations_) + " iterations";
+    return false;
+  }
+
+  // sandwich covariance H^-1 S H^-1 (S : sum of w^2 g g^T)
+  double inverse[kMaxParameters][kMaxParameters];
+  for (std::size_t j = 0; j < nparameters; ++j) {
+    double unit[kMaxParameters] = {};
+    unit[j] = 1.;
+    Solve(sums.hessian, unit, inverse[j]);
+  }
+  for (std::size_t i = 0; i < nparameters; ++i) {
+    for (std::size_t j = 0; j < nparameters; ++j) {
+      auto sum = 0.;
+      for (std::size_t k = 0; k < nparameters; ++k) {
+        for (std::size_t l = 0; l < nparameters; ++l) {
+          sum += inverse[i][k]*sums.scores[k][l]*inverse[l][j];
+        }
+      }
+      covariance_[i][j] = sum;
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+double UnbinnedFit::GetParameterError(std::size_t parameter) const
+{
+  return std::sqrt(std::max(0., covariance_[parameter][parameter]));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::size_t UnbinnedFit::GetNumberOfEvents() const
+{
+  std::size_t events = 0;
+  for (const auto& partition : partitions_) events += partition.weights.size();
+  return events;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+double UnbinnedFit::GetSumOfWeights() const
+{
+  auto sum = 0.;
+  for (const auto& partition : partitions_) {
+    for (auto weight : partition.weights) sum += weight;
+  }
+  return sum;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void UnbinnedFit::Evaluate(const double* parameters, Sums& sums) const
+{
+  // one thread per partition, summed in the order of the partitions
+  std::vector<Sums> partition_sums(partitions_.size());
+  std::vector<std::thread> threads;
+  for (std::size_t i_partition = 1; i_partition < partitions_.size(); ++i_partition) {
+    threads.emplace_back([&, i_partition]() {
+      EvaluatePartition(partitions_[i_partition], parameters, partition_sums[i_partition]);
+    });
+  }
+  EvaluatePartition(partitions_[0], parameters, partition_sums[0]);
+  for (auto& thread : threads) thread.join();
+
+  auto nparameters = names_.size();
+  sums = partition_sums[0];
+  for (std::size_t i_partition = 1; i_partition < partitions_.size(); ++i_partition) {
+    const auto& other = partition_sums[i_partition];
+    sums.valid = sums.valid && other.valid;
+    sums.nll += other.nll;
+    for (std::size_t j = 0; j < nparameters; ++j) {
+      sums.gradient[j] += other.gradient[j];
+      for (std::size_t k = 0; k < nparameters; ++k) {
+        sums.hessian[j][k] += other.hessian[j][k];
+        sums.scores[j][k] += other.scores[j][k];
+      }
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void UnbinnedFit::EvaluatePartition(const Partition& partition, const double* parameters, 
+                                    Sums& sums) const
+{
+  auto nparameters = names_.size();
+  sums.valid = true;
+  sums.nll = 0.;
+  for (std::size_t j = 0; j < nparameters; ++j) {
+    sums.gradient[j] = 0.;
+    for (std::size_t k = 0; k < nparameters; ++k) {
+      sums.hessian[j][k] = 0.;
+      sums.scores[j][k] = 0.;
+    }
+  }
+
+  double density[kChunk], ratio[kChunk], ratio2[kChunk], weight_ratio2[kChunk];
+  auto events = partition.weights.size();
+  for (std::size_t begin = 0; begin < events; begin += kChunk) {
+    auto n = std::min(kChunk, events - begin);
+    const float* weight = partition.weights.data() + begin;
+    const float* features[kMaxParameters];
+    for (std::size_t j = 0; j < nparameters; ++j) {
+      features[j] = partition.features[j].data() + begin;
+    }
+
+    // u = 1 + p.x
+    for (std::size_t i = 0; i < n; ++i) density[i] = 1.;
+    for (std::size_t j = 0; j < nparameters; ++j) {
+      auto p = parameters[j];
+      const float* x = features[j];
+      for (std::size_t i = 0; i < n; ++i) density[i] += p*x[i];
+    }
+    auto smallest = density[0];
+    for (std::size_t i = 1; i < n; ++i) smallest = std::min(smallest, density[i]);
+    if (smallest <= 0.) {
+      sums.valid = false;
+      return;
+    }
+
+    // w/u, w/u^2, w^2/u^2 and - w ln u
+    auto nll = 0.;
+    for (std::size_t i = 0; i < n; ++i) {
+      ratio[i] = weight[i]/density[i];
+      ratio2[i] = ratio[i]/density[i];
+      weight_ratio2[i] = ratio[i]*ratio[i];
+      nll -= weight[i]*std::log(density[i]);
+    }
+    sums.nll += nll;
+
+    for (std::size_t j = 0; j < nparameters; ++j) {
+      sums.gradient[j] -= Dot(ratio, features[j], n);
+      for (std::size_t k = 0; k <= j; ++k) {
+        sums.hessian[j][k] += Dot(ratio2, features[j], features[k], n);
+        sums.scores[j][k] += Dot(weight_ratio2, features[j], features[k], n);
+      }
+    }
+  }
+
+  for (std::size_t j = 0; j < nparameters; ++j) {
+    for (std::size_t k = 0; k < j; ++k) {
+      sums.hessian[k][j] = sums.hessian[j][k];
+      sums.scores[k][j] = sums.scores[j][k];
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool UnbinnedFit::Solve(const double (*hessian)[kMaxParameters], const double* b, 
+                        double* x) const
+{
+  // Cholesky decomposition H = L L^T
+  auto nparameters = names_.size();
+  double lower[kMaxParameters][kMaxParameters] = {};
+  for (std::size_t j = 0; j < nparameters; ++j) {
+    auto diagonal = hessian[j][j];
+    for (std::size_t k = 0; k < j; ++k) diagonal -= lower[j][k]*lower[j][k];
+    if (!(diagonal > 1.e-12*std::abs(hessian[j][j])) || diagonal <= 0.) return false;
+    lower[j][j] = std::sqrt(diagonal);
+    for (std::size_t i = j + 1; i < nparameters; ++i) {
+      auto sum = hessian[i][j];
+      for (std::size_t k = 0; k < j; ++k) sum -= lower[i][k]*lower[j][k];
+      lower[i][j] = sum/lower[j][j];
+    }
+  }
+
+  // L y = b, then L^T x = y
+  double y[kMaxParameters];
+  for (std::size_t i = 0; i < nparameters; ++i) {
+    auto sum = b[i];
+    for (std::size_t k = 0; k < i; ++k) sum -= lower[i][k]*y[k];
+    y[i] = sum/lower[i][i];
+  }
+  for (std::size_t i = nparameters; i-- > 0; ) {
+    auto sum = y[i];
+    for (std::size_t k = i + 1; k < nparameters; ++k) sum -= lower[k][i]*x[k];
+    x[i] = sum/lower[i][i];
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......